@@ -3,6 +3,7 @@
 #include "bg.h"
 #include "dma3.h"
 #include "gpu_regs.h"
+#include "main.h"
 
 #define DISPCNT_ALL_BG_AND_MODE_BITS    (DISPCNT_BG_ALL_ON | 0x7)
 
@@ -31,16 +32,24 @@ struct BgConfig2
 {
     u32 baseTile:10;
     u32 basePalette:4;
-    u32 unk_3:18;
+    u32 dirtyTracking:1;
+    u32 unk_3:17;
 
     void *tilemap;
     s32 bg_x;
     s32 bg_y;
+
+    // Byte range of the tilemap buffer changed since it was last copied to VRAM.
+    // Only used when dirtyTracking is set, otherwise the whole buffer is copied.
+    u16 dirtyStart;
+    u16 dirtyEnd;
 };
 
 static struct BgControl sGpuBgConfigs;
 static struct BgConfig2 sGpuBgConfigs2[NUM_BACKGROUNDS];
 static u32 sDmaBusyBitfield[NUM_BACKGROUNDS];
+static struct BgTilemapCopyStats sTilemapCopyStats;
+static struct BgTilemapCopyStats sPrevTilemapCopyStats;
 
 u32 gWindowTileAutoAllocEnabled;
 
@@ -48,6 +57,29 @@ static const struct BgConfig sZeroedBgControlStruct = { 0 };
 
 static u32 GetBgType(u8 bg);
 
+#define TILEMAP_DIRTY_ALL 0xFFFF
+
+static void MarkBgTilemapDirty(u8 bg, u32 start, u32 end)
+{
+    if (start < sGpuBgConfigs2[bg].dirtyStart)
+        sGpuBgConfigs2[bg].dirtyStart = start;
+    if (end > sGpuBgConfigs2[bg].dirtyEnd)
+        sGpuBgConfigs2[bg].dirtyEnd = end;
+}
+
+// For writes that don't wrap around the map, where cell (x, y) is at y * rowLength + x
+static void MarkBgTilemapRectDirty(u8 bg, u32 x, u32 y, u32 width, u32 height, u32 rowLength, u32 cellSize)
+{
+    if (width != 0 && height != 0)
+        MarkBgTilemapDirty(bg, (y * rowLength + x) * cellSize, ((y + height - 1) * rowLength + x + width) * cellSize);
+}
+
+static void MarkBgTilemapClean(u8 bg)
+{
+    sGpuBgConfigs2[bg].dirtyStart = TILEMAP_DIRTY_ALL;
+    sGpuBgConfigs2[bg].dirtyEnd = 0;
+}
+
 void ResetBgs(void)
 {
     ResetBgControlStructs();
@@ -333,6 +365,7 @@ void InitBgsFromTemplates(u8 bgMode, const struct BgTemplate *templates, u8 numT
 
             sGpuBgConfigs2[bg].baseTile = templates[i].baseTile;
             sGpuBgConfigs2[bg].basePalette = 0;
+            sGpuBgConfigs2[bg].dirtyTracking = FALSE;
             sGpuBgConfigs2[bg].unk_3 = 0;
 
             sGpuBgConfigs2[bg].tilemap = NULL;
@@ -359,6 +392,7 @@ void InitBgFromTemplate(const struct BgTemplate *template)
 
         sGpuBgConfigs2[bg].baseTile = template->baseTile;
         sGpuBgConfigs2[bg].basePalette = 0;
+        sGpuBgConfigs2[bg].dirtyTracking = FALSE;
         sGpuBgConfigs2[bg].unk_3 = 0;
 
         sGpuBgConfigs2[bg].tilemap = NULL;
@@ -410,6 +444,9 @@ u16 LoadBgTilemap(u8 bg, const void *src, u16 size, u16 destOffset)
         return -1;
     }
 
+    // VRAM no longer matches the tilemap buffer
+    MarkBgTilemapDirty(bg, 0, TILEMAP_DIRTY_ALL);
+
     sDmaBusyBitfield[cursor / 0x20] |= (1 << (cursor % 0x20));
 
     return cursor;
@@ -477,6 +514,9 @@ void HideBg(u8 bg)
 
 void SetBgAttribute(u8 bg, u8 attributeId, u8 value)
 {
+    if (!IsInvalidBg32(bg))
+        MarkBgTilemapDirty(bg, 0, TILEMAP_DIRTY_ALL);
+
     switch (attributeId)
     {
     case BG_ATTR_CHARBASEINDEX:
@@ -852,14 +892,26 @@ void SetBgTilemapBuffer(u8 bg, void *tilemap)
     if (!IsInvalidBg32(bg) && GetBgControlAttribute(bg, BG_CTRL_ATTR_VISIBLE))
     {
         sGpuBgConfigs2[bg].tilemap = tilemap;
+        sGpuBgConfigs2[bg].dirtyTracking = FALSE;
+        MarkBgTilemapDirty(bg, 0, TILEMAP_DIRTY_ALL);
     }
 }
 
+// Lets CopyBgTilemapBufferToVram copy only the part of the buffer changed by the
+// functions in this file. Only for buffers that nothing else holds a pointer to
+// and writes into (GetBgTilemapBuffer marks the whole buffer as changed).
+void EnableBgTilemapDirtyTracking(u8 bg)
+{
+    if (!IsInvalidBg32(bg) && !IsTileMapOutsideWram(bg))
+        sGpuBgConfigs2[bg].dirtyTracking = TRUE;
+}
+
 void UnsetBgTilemapBuffer(u8 bg)
 {
     if (!IsInvalidBg32(bg) && GetBgControlAttribute(bg, BG_CTRL_ATTR_VISIBLE))
     {
         sGpuBgConfigs2[bg].tilemap = NULL;
+        sGpuBgConfigs2[bg].dirtyTracking = FALSE;
     }
 }
 
@@ -869,8 +921,10 @@ void *GetBgTilemapBuffer(u8 bg)
         return NULL;
     else if (!GetBgControlAttribute(bg, BG_CTRL_ATTR_VISIBLE))
         return NULL;
-    else
-        return sGpuBgConfigs2[bg].tilemap;
+
+    // The caller may write anywhere in the buffer
+    MarkBgTilemapDirty(bg, 0, TILEMAP_DIRTY_ALL);
+    return sGpuBgConfigs2[bg].tilemap;
 }
 
 void CopyToBgTilemapBuffer(u8 bg, const void *src, u16 mode, u16 destOffset)
@@ -881,12 +935,31 @@ void CopyToBgTilemapBuffer(u8 bg, const void *src, u16 mode, u16 destOffset)
             CpuCopy16(src, (void *)(sGpuBgConfigs2[bg].tilemap + (destOffset * 2)), mode);
         else
             LZ77UnCompWram(src, (void *)(sGpuBgConfigs2[bg].tilemap + (destOffset * 2)));
+        MarkBgTilemapDirty(bg, 0, TILEMAP_DIRTY_ALL);
+    }
+}
+
+static void CountTilemapCopy(u16 bytesCopied, u16 bytesSkipped)
+{
+    if (sTilemapCopyStats.frame != gMain.vblankCounter1)
+    {
+        sPrevTilemapCopyStats = sTilemapCopyStats;
+        memset(&sTilemapCopyStats, 0, sizeof(sTilemapCopyStats));
+        sTilemapCopyStats.frame = gMain.vblankCounter1;
     }
+
+    if (bytesSkipped == 0)
+        sTilemapCopyStats.fullCopies++;
+    else
+        sTilemapCopyStats.partialCopies++;
+    sTilemapCopyStats.bytesCopied += bytesCopied;
+    sTilemapCopyStats.bytesSkipped += bytesSkipped;
 }
 
 void CopyBgTilemapBufferToVram(u8 bg)
 {
     u16 sizeToLoad;
+    u16 start, end;
 
     if (!IsInvalidBg32(bg) && !IsTileMapOutsideWram(bg))
     {
@@ -902,7 +975,48 @@ void CopyBgTilemapBufferToVram(u8 bg)
             sizeToLoad = 0;
             break;
         }
-        LoadBgVram(bg, sGpuBgConfigs2[bg].tilemap, sizeToLoad, 0, 2);
+
+        if (sGpuBgConfigs2[bg].dirtyTracking)
+        {
+            // VRAM takes 16-bit writes, so round out to whole halfwords
+            start = sGpuBgConfigs2[bg].dirtyStart & ~1;
+            end = min((sGpuBgConfigs2[bg].dirtyEnd + 1) & ~1, sizeToLoad);
+            if (start >= end)
+            {
+                // Nothing changed since the last copy
+                CountTilemapCopy(0, sizeToLoad);
+                return;
+            }
+        }
+        else
+        {
+            start = 0;
+            end = sizeToLoad;
+        }
+
+        // If the copy can't be queued (BG hidden, DMA queue full) keep the buffer dirty
+        if (LoadBgVram(bg, sGpuBgConfigs2[bg].tilemap + start, end - start, start, 2) != 0xFF)
+        {
+            MarkBgTilemapClean(bg);
+            CountTilemapCopy(end - start, sizeToLoad - (end - start));
+        }
+    }
+}
+
+// Counts for CopyBgTilemapBufferToVram in the current frame and in the last
+// earlier frame that copied anything.
+void GetBgTilemapCopyStats(struct BgTilemapCopyStats *thisFrame, struct BgTilemapCopyStats *lastFrame)
+{
+    if (sTilemapCopyStats.frame != gMain.vblankCounter1)
+    {
+        *lastFrame = sTilemapCopyStats;
+        memset(thisFrame, 0, sizeof(*thisFrame));
+        thisFrame->frame = gMain.vblankCounter1;
+    }
+    else
+    {
+        *thisFrame = sTilemapCopyStats;
+        *lastFrame = sPrevTilemapCopyStats;
     }
 }
 
@@ -926,6 +1040,7 @@ void CopyToBgTilemapBufferRect(u8 bg, const void *src, u8 destX, u8 destY, u8 wi
                     ((u16 *)sGpuBgConfigs2[bg].tilemap)[((destY16 * 0x20) + destX16)] = *srcCopy++;
                 }
             }
+            MarkBgTilemapRectDirty(bg, destX, destY, width, height, 0x20, 2);
             break;
         }
         case BG_TYPE_AFFINE:
@@ -939,6 +1054,7 @@ void CopyToBgTilemapBufferRect(u8 bg, const void *src, u8 destX, u8 destY, u8 wi
                     ((u8 *)sGpuBgConfigs2[bg].tilemap)[((destY16 * mode) + destX16)] = *srcCopy++;
                 }
             }
+            MarkBgTilemapRectDirty(bg, destX, destY, width, height, mode, 1);
             break;
         }
         }
@@ -956,6 +1072,7 @@ void CopyRectToBgTilemapBufferRect(u8 bg, const void *src, u8 srcX, u8 srcY, u8
     u16 var;
     const void *srcPtr;
     u16 i, j;
+    u16 minIndex = 0xFFFF, maxIndex = 0;
 
     if (!IsInvalidBg32(bg) && !IsTileMapOutsideWram(bg))
     {
@@ -973,9 +1090,15 @@ void CopyRectToBgTilemapBufferRect(u8 bg, const void *src, u8 srcX, u8 srcY, u8
                     u16 index = GetTileMapIndexFromCoords(j, i, screenSize, screenWidth, screenHeight);
                     CopyTileMapEntry(srcPtr, sGpuBgConfigs2[bg].tilemap + (index * 2), palette1, tileOffset, palette2);
                     srcPtr += 2;
+                    if (index < minIndex)
+                        minIndex = index;
+                    if (index > maxIndex)
+                        maxIndex = index;
                 }
                 srcPtr += (srcWidth - rectWidth) * 2;
             }
+            if (minIndex <= maxIndex)
+                MarkBgTilemapDirty(bg, minIndex * 2, (maxIndex + 1) * 2);
             break;
         case BG_TYPE_AFFINE:
             srcPtr = src + ((srcY * srcWidth) + srcX);
@@ -989,6 +1112,7 @@ void CopyRectToBgTilemapBufferRect(u8 bg, const void *src, u8 srcX, u8 srcY, u8
                 }
                 srcPtr += (srcWidth - rectWidth);
             }
+            MarkBgTilemapRectDirty(bg, destX, destY, rectWidth, rectHeight, var, 1);
             break;
         }
     }
@@ -1012,6 +1136,7 @@ void FillBgTilemapBufferRect_Palette0(u8 bg, u16 tileNum, u8 x, u8 y, u8 width,
                     ((u16 *)sGpuBgConfigs2[bg].tilemap)[((y16 * 0x20) + x16)] = tileNum;
                 }
             }
+            MarkBgTilemapRectDirty(bg, x, y, width, height, 0x20, 2);
             break;
         case BG_TYPE_AFFINE:
             mode = GetBgMetricAffineMode(bg, 0x1);
@@ -1022,6 +1147,7 @@ void FillBgTilemapBufferRect_Palette0(u8 bg, u16 tileNum, u8 x, u8 y, u8 width,
                     ((u8 *)sGpuBgConfigs2[bg].tilemap)[((y16 * mode) + x16)] = tileNum;
                 }
             }
+            MarkBgTilemapRectDirty(bg, x, y, width, height, mode, 1);
             break;
         }
     }
@@ -1039,6 +1165,7 @@ void WriteSequenceToBgTilemapBuffer(u8 bg, u16 firstTileNum, u8 x, u8 y, u8 widt
     u16 attribute;
     u16 mode3;
     u16 x16, y16;
+    u16 index, minIndex = 0xFFFF, maxIndex = 0;
 
     if (!IsInvalidBg32(bg) && !IsTileMapOutsideWram(bg))
     {
@@ -1052,10 +1179,17 @@ void WriteSequenceToBgTilemapBuffer(u8 bg, u16 firstTileNum, u8 x, u8 y, u8 widt
             {
                 for (x16 = x; x16 < (x + width); x16++)
                 {
-                    CopyTileMapEntry(&firstTileNum, &((u16 *)sGpuBgConfigs2[bg].tilemap)[(u16)GetTileMapIndexFromCoords(x16, y16, attribute, mode, mode2)], paletteSlot, 0, 0);
+                    index = GetTileMapIndexFromCoords(x16, y16, attribute, mode, mode2);
+                    CopyTileMapEntry(&firstTileNum, &((u16 *)sGpuBgConfigs2[bg].tilemap)[index], paletteSlot, 0, 0);
                     firstTileNum = (firstTileNum & (MAPGRID_COLLISION_MASK | MAPGRID_ELEVATION_MASK)) + ((firstTileNum + tileNumDelta) & MAPGRID_METATILE_ID_MASK);
+                    if (index < minIndex)
+                        minIndex = index;
+                    if (index > maxIndex)
+                        maxIndex = index;
                 }
             }
+            if (minIndex <= maxIndex)
+                MarkBgTilemapDirty(bg, minIndex * 2, (maxIndex + 1) * 2);
             break;
         case BG_TYPE_AFFINE:
             mode3 = GetBgMetricAffineMode(bg, 0x1);
@@ -1067,6 +1201,7 @@ void WriteSequenceToBgTilemapBuffer(u8 bg, u16 firstTileNum, u8 x, u8 y, u8 widt
                     firstTileNum = (firstTileNum & (MAPGRID_COLLISION_MASK | MAPGRID_ELEVATION_MASK)) + ((firstTileNum + tileNumDelta) & MAPGRID_METATILE_ID_MASK);
                 }
             }
+            MarkBgTilemapRectDirty(bg, x, y, width, height, mode3, 1);
             break;
         }
     }
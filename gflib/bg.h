@@ -50,6 +50,16 @@ struct BgTemplate
     u16 baseTile:10;
 };
 
+// Counts for CopyBgTilemapBufferToVram over one frame
+struct BgTilemapCopyStats
+{
+    u32 frame; // gMain.vblankCounter1
+    u16 fullCopies;
+    u16 partialCopies; // including copies skipped because nothing changed
+    u32 bytesCopied;
+    u32 bytesSkipped;
+};
+
 void ResetBgs(void);
 u8 GetBgMode(void);
 void ResetBgControlStructs(void);
@@ -79,9 +89,11 @@ void SetBgAffine(u8 bg, s32 srcCenterX, s32 srcCenterY, s16 dispCenterX, s16 dis
 u8 Unused_AdjustBgMosaic(u8 val, u8 mode);
 void SetBgTilemapBuffer(u8 bg, void *tilemap);
 void UnsetBgTilemapBuffer(u8 bg);
+void EnableBgTilemapDirtyTracking(u8 bg);
 void *GetBgTilemapBuffer(u8 bg);
 void CopyToBgTilemapBuffer(u8 bg, const void *src, u16 mode, u16 destOffset);
 void CopyBgTilemapBufferToVram(u8 bg);
+void GetBgTilemapCopyStats(struct BgTilemapCopyStats *thisFrame, struct BgTilemapCopyStats *lastFrame);
 void CopyToBgTilemapBufferRect(u8 bg, const void *src, u8 destX, u8 destY, u8 width, u8 height);
 void CopyToBgTilemapBufferRect_ChangePalette(u8 bg, const void *src, u8 destX, u8 destY, u8 rectWidth, u8 rectHeight, u8 palette);
 void CopyRectToBgTilemapBufferRect(u8 bg, const void *src, u8 srcX, u8 srcY, u8 srcWidth, u8 srcHeight, u8 destX, u8 destY, u8 rectWidth, u8 rectHeight, u8 palette1, s16 tileOffset, s16 palette2);
@@ -4,6 +4,17 @@
 // Maximum amount of data we will transfer in one operation
 #define MAX_DMA_BLOCK_SIZE 0x1000
 
+struct Dma3Stats
+{
+    u32 bytesQueued; // by requests made since the VBlank before
+    u32 bytesTransferred;
+    u32 bytesDeferred; // left queued for the next VBlank
+    u16 requestsQueued;
+    u16 requestsCoalesced; // merged into a queued request instead of taking a new one
+    u8 overrunLines; // scanlines the last transfer ran past the end of VBlank
+    u8 worstOverrunLines; // since ClearDma3Requests
+};
+
 #define Dma3CopyLarge_(src, dest, size, bit)               \
 {                                                          \
     const void *_src = src;                                \
@@ -51,5 +62,6 @@ void ProcessDma3Requests(void);
 s16 RequestDma3Copy(const void *src, void *dest, u16 size, u8 mode);
 s16 RequestDma3Fill(s32 value, void *dest, u16 size, u8 mode);
 s16 CheckForSpaceForDma3Request(s16 index);
+void GetDma3Stats(struct Dma3Stats *stats);
 
 #endif // GUARD_DMA3_H
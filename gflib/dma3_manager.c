@@ -8,40 +8,86 @@
 #define DMA_REQUEST_COPY16 3
 #define DMA_REQUEST_FILL16 4
 
+#define DMA_REQUEST_NONE 0xFF
+
+// Don't transfer more than this in one VBlank
+#define DMA_VBLANK_BUDGET (40 * 1024)
+
+// How many of the most recently queued requests a new one can be merged into
+#define DMA_MERGE_WINDOW 8
+
 struct Dma3Request
 {
     const u8 *src;
     u8 *dest;
     u16 size;
-    u16 mode;
+    u8 mode;
+    u8 next; // Next request in the queue, or the next free request
     u32 value;
 };
 
 static struct Dma3Request sDma3Requests[MAX_DMA_REQUESTS];
 
 static vbool8 sDma3ManagerLocked;
-static u8 sDma3RequestCursor;
+static u8 sDma3FreeHead;
+static u8 sDma3QueueHead;
+static u8 sDma3QueueTail;
+static u32 sDma3QueuedBytes;
+static u8 sDma3RecentRequests[DMA_MERGE_WINDOW]; // Newest at sDma3RecentCount - 1
+static u8 sDma3RecentCount;
+static struct Dma3Stats sDma3Stats;
+static struct Dma3Stats sDma3LastVBlankStats;
+static u8 sDma3WorstOverrunLines;
 
 void ClearDma3Requests(void)
 {
     int i;
 
     sDma3ManagerLocked = TRUE;
-    sDma3RequestCursor = 0;
 
     for (i = 0; i < MAX_DMA_REQUESTS; i++)
     {
         sDma3Requests[i].size = 0;
         sDma3Requests[i].src = NULL;
         sDma3Requests[i].dest = NULL;
+        sDma3Requests[i].next = i + 1;
     }
+    sDma3Requests[MAX_DMA_REQUESTS - 1].next = DMA_REQUEST_NONE;
+    sDma3FreeHead = 0;
+
+    sDma3QueueHead = DMA_REQUEST_NONE;
+    sDma3QueueTail = DMA_REQUEST_NONE;
+    sDma3QueuedBytes = 0;
+    sDma3RecentCount = 0;
+
+    memset(&sDma3Stats, 0, sizeof(sDma3Stats));
+    memset(&sDma3LastVBlankStats, 0, sizeof(sDma3LastVBlankStats));
+    sDma3WorstOverrunLines = 0;
 
     sDma3ManagerLocked = FALSE;
 }
 
+// Finishes the stats for this VBlank. A transfer that started just before the
+// end of VBlank can still run into the next frame's first scanlines.
+static void EndDma3Stats(u32 bytesTransferred)
+{
+    u8 vcount = *(u8 *)REG_ADDR_VCOUNT;
+
+    sDma3Stats.bytesTransferred = bytesTransferred;
+    sDma3Stats.bytesDeferred = sDma3QueuedBytes;
+    sDma3Stats.overrunLines = vcount < DISPLAY_HEIGHT ? vcount + 1 : 0;
+    if (sDma3Stats.overrunLines > sDma3WorstOverrunLines)
+        sDma3WorstOverrunLines = sDma3Stats.overrunLines;
+    sDma3Stats.worstOverrunLines = sDma3WorstOverrunLines;
+
+    sDma3LastVBlankStats = sDma3Stats;
+    memset(&sDma3Stats, 0, sizeof(sDma3Stats));
+}
+
 void ProcessDma3Requests(void)
 {
-    u16 bytesTransferred;
+    u32 bytesTransferred;
+    u8 cursor;
 
     if (sDma3ManagerLocked)
         return;
@@ -49,129 +95,195 @@ void ProcessDma3Requests(void)
     bytesTransferred = 0;
 
     // as long as there are DMA requests to process (unless size or vblank is an issue), do not exit
-    while (sDma3Requests[sDma3RequestCursor].size != 0)
+    while (sDma3QueueHead != DMA_REQUEST_NONE)
     {
-        bytesTransferred += sDma3Requests[sDma3RequestCursor].size;
+        cursor = sDma3QueueHead;
 
-        if (bytesTransferred > 40 * 1024)
-            return; // don't transfer more than 40 KiB
+        if (bytesTransferred + sDma3Requests[cursor].size > DMA_VBLANK_BUDGET)
+            break; // don't transfer more than 40 KiB
         if (*(u8 *)REG_ADDR_VCOUNT > 224)
-            return; // we're about to leave vblank, stop
+            break; // we're about to leave vblank, stop
+        bytesTransferred += sDma3Requests[cursor].size;
 
-        switch (sDma3Requests[sDma3RequestCursor].mode)
+        switch (sDma3Requests[cursor].mode)
         {
         case DMA_REQUEST_COPY32: // regular 32-bit copy
-            Dma3CopyLarge32_(sDma3Requests[sDma3RequestCursor].src,
-                             sDma3Requests[sDma3RequestCursor].dest,
-                             sDma3Requests[sDma3RequestCursor].size);
+            Dma3CopyLarge32_(sDma3Requests[cursor].src,
+                             sDma3Requests[cursor].dest,
+                             sDma3Requests[cursor].size);
             break;
         case DMA_REQUEST_FILL32: // repeat a single 32-bit value across RAM
-            Dma3FillLarge32_(sDma3Requests[sDma3RequestCursor].value,
-                             sDma3Requests[sDma3RequestCursor].dest,
-                             sDma3Requests[sDma3RequestCursor].size);
+            Dma3FillLarge32_(sDma3Requests[cursor].value,
+                             sDma3Requests[cursor].dest,
+                             sDma3Requests[cursor].size);
             break;
         case DMA_REQUEST_COPY16:    // regular 16-bit copy
-            Dma3CopyLarge16_(sDma3Requests[sDma3RequestCursor].src,
-                             sDma3Requests[sDma3RequestCursor].dest,
-                             sDma3Requests[sDma3RequestCursor].size);
+            Dma3CopyLarge16_(sDma3Requests[cursor].src,
+                             sDma3Requests[cursor].dest,
+                             sDma3Requests[cursor].size);
             break;
         case DMA_REQUEST_FILL16: // repeat a single 16-bit value across RAM
-            Dma3FillLarge16_(sDma3Requests[sDma3RequestCursor].value,
-                             sDma3Requests[sDma3RequestCursor].dest,
-                             sDma3Requests[sDma3RequestCursor].size);
+            Dma3FillLarge16_(sDma3Requests[cursor].value,
+                             sDma3Requests[cursor].dest,
+                             sDma3Requests[cursor].size);
             break;
         }
 
-        // Free the request
-        sDma3Requests[sDma3RequestCursor].src = NULL;
-        sDma3Requests[sDma3RequestCursor].dest = NULL;
-        sDma3Requests[sDma3RequestCursor].size = 0;
-        sDma3Requests[sDma3RequestCursor].mode = 0;
-        sDma3Requests[sDma3RequestCursor].value = 0;
-        sDma3RequestCursor++;
+        // Take the request off the queue and free it
+        sDma3QueueHead = sDma3Requests[cursor].next;
+        if (sDma3QueueHead == DMA_REQUEST_NONE)
+            sDma3QueueTail = DMA_REQUEST_NONE;
+        sDma3QueuedBytes -= sDma3Requests[cursor].size;
 
-        if (sDma3RequestCursor >= MAX_DMA_REQUESTS) // loop back to the first DMA request
-            sDma3RequestCursor = 0;
+        sDma3Requests[cursor].src = NULL;
+        sDma3Requests[cursor].dest = NULL;
+        sDma3Requests[cursor].size = 0;
+        sDma3Requests[cursor].mode = 0;
+        sDma3Requests[cursor].value = 0;
+        sDma3Requests[cursor].next = sDma3FreeHead;
+        sDma3FreeHead = cursor;
+
+        // Freed requests may be handed out again, so nothing is merged across a VBlank
+        sDma3RecentCount = 0;
     }
+
+    EndDma3Stats(bytesTransferred);
 }
 
-s16 RequestDma3Copy(const void *src, void *dest, u16 size, u8 mode)
+static bool32 RangesOverlap(const u8 *a, u32 aSize, const u8 *b, u32 bSize)
 {
-    int cursor;
-    int i = 0;
+    return a < b + bSize && b < a + aSize;
+}
 
-    sDma3ManagerLocked = TRUE;
-    cursor = sDma3RequestCursor;
+static bool32 IsCopyRequest(u8 mode)
+{
+    return mode == DMA_REQUEST_COPY32 || mode == DMA_REQUEST_COPY16;
+}
 
-    while (i < MAX_DMA_REQUESTS)
-    {
-        if (sDma3Requests[cursor].size == 0) // an empty request was found.
-        {
-            sDma3Requests[cursor].src = src;
-            sDma3Requests[cursor].dest = dest;
-            sDma3Requests[cursor].size = size;
+// Whether running request and the new transfer in either order could give a
+// different result.
+static bool32 DoDma3RequestsConflict(const struct Dma3Request *request, const u8 *src, u8 *dest, u16 size, u8 mode)
+{
+    return RangesOverlap(request->dest, request->size, dest, size)
+        || (IsCopyRequest(mode) && RangesOverlap(request->dest, request->size, src, size))
+        || (IsCopyRequest(request->mode) && RangesOverlap(request->src, request->size, dest, size));
+}
 
-            if (mode == 1)
-                sDma3Requests[cursor].mode = DMA_REQUEST_COPY32;
-            else
-                sDma3Requests[cursor].mode = DMA_REQUEST_COPY16;
+// Returns the index of a recently queued request that already does what was
+// asked, after growing it if needed, or -1 if a new request has to be queued.
+// Only the last DMA_MERGE_WINDOW requests are looked at, so this doesn't get
+// slower as the queue fills up.
+static s16 TryCoalesceDma3Request(const u8 *src, u8 *dest, u16 size, u8 mode, u32 value)
+{
+    struct Dma3Request *request;
+    s32 i;
 
-            sDma3ManagerLocked = FALSE;
-            return cursor;
-        }
-        if (++cursor >= MAX_DMA_REQUESTS) // loop back to start.
-            cursor = 0;
-        i++;
+    if (sDma3RecentCount == 0)
+        return -1;
+
+    // Extend the last queued request if this carries straight on from it.
+    // Nothing can have been queued in between, so the order doesn't change.
+    request = &sDma3Requests[sDma3RecentRequests[sDma3RecentCount - 1]];
+    if (request->mode == mode
+     && request->dest + request->size == dest
+     && request->size + size <= DMA_VBLANK_BUDGET
+     && (IsCopyRequest(mode) ? request->src + request->size == src : request->value == value)
+     && !DoDma3RequestsConflict(request, src, dest, size, mode))
+    {
+        request->size += size;
+        sDma3QueuedBytes += size;
+        return sDma3RecentRequests[sDma3RecentCount - 1];
     }
-    sDma3ManagerLocked = FALSE;
-    return -1;  // no free DMA request was found
+
+    // Drop the request if the same transfer is queued and nothing after it
+    // touches the same memory. A copy reads its source when it runs, so the
+    // queued one picks up any newer data.
+    for (i = sDma3RecentCount - 1; i >= 0; i--)
+    {
+        request = &sDma3Requests[sDma3RecentRequests[i]];
+        if (request->mode == mode && request->dest == dest && request->size == size
+         && (IsCopyRequest(mode) ? request->src == src : request->value == value))
+            return sDma3RecentRequests[i];
+        if (DoDma3RequestsConflict(request, src, dest, size, mode))
+            break;
+    }
+
+    return -1;
 }
 
-s16 RequestDma3Fill(s32 value, void *dest, u16 size, u8 mode)
+static s16 QueueDma3Request(const void *src, void *dest, u16 size, u8 mode, u32 value)
 {
-    int cursor;
-    int i = 0;
+    s16 cursor;
 
-    cursor = sDma3RequestCursor;
     sDma3ManagerLocked = TRUE;
 
-    while (i < MAX_DMA_REQUESTS)
+    cursor = TryCoalesceDma3Request(src, dest, size, mode, value);
+    if (cursor != -1)
     {
-        if (sDma3Requests[cursor].size == 0) // an empty request was found.
-        {
-            sDma3Requests[cursor].dest = dest;
-            sDma3Requests[cursor].size = size;
-            sDma3Requests[cursor].mode = mode;
-            sDma3Requests[cursor].value = value;
-
-            if(mode == 1)
-                sDma3Requests[cursor].mode = DMA_REQUEST_FILL32;
-            else
-                sDma3Requests[cursor].mode = DMA_REQUEST_FILL16;
-
-            sDma3ManagerLocked = FALSE;
-            return cursor;
-        }
-        if (++cursor >= MAX_DMA_REQUESTS) // loop back to start.
-            cursor = 0;
-        i++;
+        sDma3Stats.bytesQueued += size;
+        sDma3Stats.requestsCoalesced++;
+        sDma3ManagerLocked = FALSE;
+        return cursor;
     }
+
+    cursor = sDma3FreeHead;
+    if (cursor == DMA_REQUEST_NONE)
+    {
+        sDma3ManagerLocked = FALSE;
+        return -1;  // no free DMA request was found
+    }
+    sDma3FreeHead = sDma3Requests[cursor].next;
+
+    sDma3Requests[cursor].src = src;
+    sDma3Requests[cursor].dest = dest;
+    sDma3Requests[cursor].size = size;
+    sDma3Requests[cursor].mode = mode;
+    sDma3Requests[cursor].value = value;
+    sDma3Requests[cursor].next = DMA_REQUEST_NONE;
+
+    if (sDma3QueueTail == DMA_REQUEST_NONE)
+        sDma3QueueHead = cursor;
+    else
+        sDma3Requests[sDma3QueueTail].next = cursor;
+    sDma3QueueTail = cursor;
+    sDma3QueuedBytes += size;
+
+    if (sDma3RecentCount == DMA_MERGE_WINDOW)
+    {
+        memmove(&sDma3RecentRequests[0], &sDma3RecentRequests[1], DMA_MERGE_WINDOW - 1);
+        sDma3RecentCount--;
+    }
+    sDma3RecentRequests[sDma3RecentCount++] = cursor;
+
+    sDma3Stats.bytesQueued += size;
+    sDma3Stats.requestsQueued++;
+
     sDma3ManagerLocked = FALSE;
-    return -1;  // no free DMA request was found
+    return cursor;
 }
 
-s16 CheckForSpaceForDma3Request(s16 index)
+s16 RequestDma3Copy(const void *src, void *dest, u16 size, u8 mode)
+{
+    return QueueDma3Request(src, dest, size, mode == 1 ? DMA_REQUEST_COPY32 : DMA_REQUEST_COPY16, 0);
+}
+
+s16 RequestDma3Fill(s32 value, void *dest, u16 size, u8 mode)
+{
+    return QueueDma3Request(NULL, dest, size, mode == 1 ? DMA_REQUEST_FILL32 : DMA_REQUEST_FILL16, value);
+}
+
+// Stats for the requests made before the last VBlank and what that VBlank transferred
+void GetDma3Stats(struct Dma3Stats *stats)
 {
-    int i = 0;
+    *stats = sDma3LastVBlankStats;
+}
 
+s16 CheckForSpaceForDma3Request(s16 index)
+{
     if (index == -1)  // check if all requests are free
     {
-        while (i < MAX_DMA_REQUESTS)
-        {
-            if (sDma3Requests[i].size != 0)
-                return -1;
-            i++;
-        }
+        if (sDma3QueueHead != DMA_REQUEST_NONE)
+            return -1;
         return 0;
     }
     else  // check the specified request
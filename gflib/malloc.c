@@ -1,4 +1,5 @@
 #include "global.h"
+#include "malloc.h"
 
 static void *sHeapStart;
 static u32 sHeapSize;
@@ -25,6 +26,93 @@ struct MemBlock {
     u8 data[0];
 };
 
+// Unused blocks are kept in free lists segregated by size, so allocating
+// doesn't have to walk every block in the heap. The links are stored in the
+// block's data, which is why no block is smaller than MIN_BLOCK_SIZE.
+struct FreeLinks {
+    struct MemBlock *prevFree;
+    struct MemBlock *nextFree;
+};
+
+#define MIN_BLOCK_SIZE sizeof(struct FreeLinks)
+
+// List i holds the unused blocks with sizes in [8 << i, 16 << i), except for
+// the last list, which holds everything larger.
+#define NUM_FREE_LISTS 14
+
+#define FREE_LINKS(block) ((struct FreeLinks *)(block)->data)
+
+static struct MemBlock *sFreeLists[NUM_FREE_LISTS];
+static u16 sNonEmptyFreeLists; // bit i is set if sFreeLists[i] isn't empty
+static u32 sUsedBytes;
+static u32 sPeakUsedBytes;
+
+#if DEBUG_HEAP_CALLSITES == TRUE
+static EWRAM_DATA struct HeapCallsite sHeapCallsites[HEAP_CALLSITE_COUNT] = {0};
+#endif
+
+static u32 GetFreeListIndex(u32 size)
+{
+    u32 index = 0;
+
+    size /= MIN_BLOCK_SIZE * 2;
+
+    while (size != 0 && index < NUM_FREE_LISTS - 1) {
+        size >>= 1;
+        index++;
+    }
+
+    return index;
+}
+
+// Each list is kept in address order. Preferring low addresses, like the
+// first-fit search this replaced, keeps the end of the heap free for large
+// allocations and fragments the heap less than reusing the newest block.
+static void InsertFreeBlock(struct MemBlock *block)
+{
+    u32 index = GetFreeListIndex(block->size);
+    struct MemBlock *prevFree = NULL;
+    struct MemBlock *nextFree = sFreeLists[index];
+
+    while (nextFree != NULL && nextFree < block) {
+        prevFree = nextFree;
+        nextFree = FREE_LINKS(nextFree)->nextFree;
+    }
+
+    FREE_LINKS(block)->prevFree = prevFree;
+    FREE_LINKS(block)->nextFree = nextFree;
+
+    if (nextFree != NULL)
+        FREE_LINKS(nextFree)->prevFree = block;
+
+    if (prevFree != NULL)
+        FREE_LINKS(prevFree)->nextFree = block;
+    else
+        sFreeLists[index] = block;
+
+    sNonEmptyFreeLists |= 1 << index;
+}
+
+static void RemoveFreeBlock(struct MemBlock *block)
+{
+    struct MemBlock *prevFree = FREE_LINKS(block)->prevFree;
+    struct MemBlock *nextFree = FREE_LINKS(block)->nextFree;
+
+    if (nextFree != NULL)
+        FREE_LINKS(nextFree)->prevFree = prevFree;
+
+    if (prevFree != NULL) {
+        FREE_LINKS(prevFree)->nextFree = nextFree;
+    } else {
+        u32 index = GetFreeListIndex(block->size);
+
+        sFreeLists[index] = nextFree;
+
+        if (nextFree == NULL)
+            sNonEmptyFreeLists &= ~(1 << index);
+    }
+}
+
 void PutMemBlockHeader(void *block, struct MemBlock *prev, struct MemBlock *next, u32 size)
 {
     struct MemBlock *header = (struct MemBlock *)block;
@@ -41,10 +129,33 @@ void PutFirstMemBlockHeader(void *block, u32 size)
     PutMemBlockHeader(block, (struct MemBlock *)block, (struct MemBlock *)block, size - sizeof(struct MemBlock));
 }
 
+// Finds an unused block of at least `size` bytes. Blocks in the size class
+// of the request may still be too small, so that list is searched first-fit.
+// Any block in a larger class is big enough, so only the first block of each
+// of those lists needs to be compared.
+static struct MemBlock *FindFreeBlock(u32 size)
+{
+    u32 index = GetFreeListIndex(size);
+    struct MemBlock *block;
+    struct MemBlock *lowestBlock = NULL;
+
+    for (block = sFreeLists[index]; block != NULL; block = FREE_LINKS(block)->nextFree) {
+        if (block->size >= size)
+            return block;
+    }
+
+    for (index++; index < NUM_FREE_LISTS; index++) {
+        if ((sNonEmptyFreeLists & (1 << index)) && (lowestBlock == NULL || sFreeLists[index] < lowestBlock))
+            lowestBlock = sFreeLists[index];
+    }
+
+    return lowestBlock;
+}
+
 void *AllocInternal(void *heapStart, u32 size)
 {
-    struct MemBlock *pos = (struct MemBlock *)heapStart;
-    struct MemBlock *head = pos;
+    struct MemBlock *head = (struct MemBlock *)heapStart;
+    struct MemBlock *pos;
     struct MemBlock *splitBlock;
     u32 foundBlockSize;
 
@@ -52,45 +163,48 @@ void *AllocInternal(void *heapStart, u32 size)
     if (size & 3)
         size = 4 * ((size / 4) + 1);
 
-    for (;;) {
-        // Loop through the blocks looking for unused block that's big enough.
+    if (size < MIN_BLOCK_SIZE)
+        size = MIN_BLOCK_SIZE;
 
-        if (!pos->flag) {
-            foundBlockSize = pos->size;
+    pos = FindFreeBlock(size);
 
-            if (foundBlockSize >= size) {
-                if (foundBlockSize - size < 2 * sizeof(struct MemBlock)) {
-                    // The block isn't much bigger than the requested size,
-                    // so just use it.
-                    pos->flag = TRUE;
-                } else {
-                    // The block is significantly bigger than the requested
-                    // size, so split the rest into a separate block.
-                    foundBlockSize -= sizeof(struct MemBlock);
-                    foundBlockSize -= size;
+    if (pos == NULL)
+        return NULL;
 
-                    splitBlock = (struct MemBlock *)(pos->data + size);
+    RemoveFreeBlock(pos);
+    foundBlockSize = pos->size;
 
-                    pos->flag = TRUE;
-                    pos->size = size;
+    if (foundBlockSize - size < 2 * sizeof(struct MemBlock)) {
+        // The block isn't much bigger than the requested size,
+        // so just use it.
+        pos->flag = TRUE;
+    } else {
+        // The block is significantly bigger than the requested
+        // size, so split the rest into a separate block.
+        foundBlockSize -= sizeof(struct MemBlock);
+        foundBlockSize -= size;
 
-                    PutMemBlockHeader(splitBlock, pos, pos->next, foundBlockSize);
+        splitBlock = (struct MemBlock *)(pos->data + size);
 
-                    pos->next = splitBlock;
+        pos->flag = TRUE;
+        pos->size = size;
 
-                    if (splitBlock->next != head)
-                        splitBlock->next->prev = splitBlock;
-                }
+        PutMemBlockHeader(splitBlock, pos, pos->next, foundBlockSize);
 
-                return pos->data;
-            }
-        }
+        pos->next = splitBlock;
 
-        if (pos->next == head)
-            return NULL;
+        if (splitBlock->next != head)
+            splitBlock->next->prev = splitBlock;
 
-        pos = pos->next;
+        InsertFreeBlock(splitBlock);
     }
+
+    sUsedBytes += sizeof(struct MemBlock) + pos->size;
+
+    if (sUsedBytes > sPeakUsedBytes)
+        sPeakUsedBytes = sUsedBytes;
+
+    return pos->data;
 }
 
 void FreeInternal(void *heapStart, void *pointer)
@@ -99,11 +213,13 @@ void FreeInternal(void *heapStart, void *pointer)
         struct MemBlock *head = (struct MemBlock *)heapStart;
         struct MemBlock *block = (struct MemBlock *)((u8 *)pointer - sizeof(struct MemBlock));
         block->flag = FALSE;
+        sUsedBytes -= sizeof(struct MemBlock) + block->size;
 
         // If the freed block isn't the last one, merge with the next block
         // if it's not in use.
         if (block->next != head) {
             if (!block->next->flag) {
+                RemoveFreeBlock(block->next);
                 block->size += sizeof(struct MemBlock) + block->next->size;
                 block->next->magic = 0;
                 block->next = block->next->next;
@@ -116,15 +232,21 @@ void FreeInternal(void *heapStart, void *pointer)
         // if it's not in use.
         if (block != head) {
             if (!block->prev->flag) {
-                block->prev->next = block->next;
+                struct MemBlock *prev = block->prev;
+
+                RemoveFreeBlock(prev);
+                prev->next = block->next;
 
                 if (block->next != head)
-                    block->next->prev = block->prev;
+                    block->next->prev = prev;
 
                 block->magic = 0;
-                block->prev->size += sizeof(struct MemBlock) + block->size;
+                prev->size += sizeof(struct MemBlock) + block->size;
+                block = prev;
             }
         }
+
+        InsertFreeBlock(block);
     }
 }
 
@@ -170,18 +292,50 @@ bool32 CheckMemBlockInternal(void *heapStart, void *pointer)
 
 void InitHeap(void *heapStart, u32 heapSize)
 {
+    u32 i;
+
     sHeapStart = heapStart;
     sHeapSize = heapSize;
     PutFirstMemBlockHeader(heapStart, heapSize);
+
+    for (i = 0; i < NUM_FREE_LISTS; i++)
+        sFreeLists[i] = NULL;
+
+    sNonEmptyFreeLists = 0;
+    sUsedBytes = 0;
+    sPeakUsedBytes = 0;
+    InsertFreeBlock((struct MemBlock *)heapStart);
+}
+
+#if DEBUG_HEAP_CALLSITES == TRUE
+static void CountAllocCallsite(const void *callsite, u32 size)
+{
+    u32 i;
+
+    for (i = 0; i < HEAP_CALLSITE_COUNT; i++) {
+        if (sHeapCallsites[i].callsite == callsite || sHeapCallsites[i].callsite == NULL) {
+            sHeapCallsites[i].callsite = callsite;
+            sHeapCallsites[i].allocCount++;
+            sHeapCallsites[i].totalSize += size;
+            return;
+        }
+    }
 }
+#endif
 
 void *Alloc(u32 size)
 {
+#if DEBUG_HEAP_CALLSITES == TRUE
+    CountAllocCallsite(__builtin_return_address(0), size);
+#endif
     return AllocInternal(sHeapStart, size);
 }
 
 void *AllocZeroed(u32 size)
 {
+#if DEBUG_HEAP_CALLSITES == TRUE
+    CountAllocCallsite(__builtin_return_address(0), size);
+#endif
     return AllocZeroedInternal(sHeapStart, size);
 }
 
@@ -207,3 +361,39 @@ bool32 CheckHeap()
 
     return TRUE;
 }
+
+// Walks the whole heap, so this is only meant for debugging.
+void GetHeapStats(struct HeapStats *stats)
+{
+    struct MemBlock *pos = (struct MemBlock *)sHeapStart;
+
+    stats->heapSize = sHeapSize;
+    stats->usedBytes = sUsedBytes;
+    stats->peakUsedBytes = sPeakUsedBytes;
+    stats->freeBytes = 0;
+    stats->largestFreeBlock = 0;
+    stats->usedBlocks = 0;
+    stats->freeBlocks = 0;
+
+    do {
+        if (pos->flag) {
+            stats->usedBlocks++;
+        } else {
+            stats->freeBlocks++;
+            stats->freeBytes += pos->size;
+
+            if (pos->size > stats->largestFreeBlock)
+                stats->largestFreeBlock = pos->size;
+        }
+        pos = pos->next;
+    } while (pos != (struct MemBlock *)sHeapStart);
+}
+
+const struct HeapCallsite *GetHeapCallsites(void)
+{
+#if DEBUG_HEAP_CALLSITES == TRUE
+    return sHeapCallsites;
+#else
+    return NULL;
+#endif
+}
@@ -11,11 +11,35 @@
 
 #define TRY_FREE_AND_SET_NULL(ptr) if (ptr != NULL) FREE_AND_SET_NULL(ptr)
 
+#define HEAP_CALLSITE_COUNT 32
+
+struct HeapStats
+{
+    u32 heapSize;
+    u32 usedBytes; // including block headers
+    u32 peakUsedBytes;
+    u32 freeBytes;
+    u32 largestFreeBlock;
+    u16 usedBlocks;
+    u16 freeBlocks;
+};
+
+// Alloc/AllocZeroed calls made from one return address.
+// Only recorded when DEBUG_HEAP_CALLSITES is enabled.
+struct HeapCallsite
+{
+    const void *callsite;
+    u16 allocCount;
+    u32 totalSize;
+};
+
 extern u8 gHeap[];
 
 void *Alloc(u32 size);
 void *AllocZeroed(u32 size);
 void Free(void *pointer);
 void InitHeap(void *pointer, u32 size);
+void GetHeapStats(struct HeapStats *stats);
+const struct HeapCallsite *GetHeapCallsites(void);
 
 #endif // GUARD_ALLOC_H
@@ -28,6 +28,13 @@
 
 #define SPRITE_TILE_IS_ALLOCATED(n) ((sSpriteTileAllocBitmap[(n) / 8] >> ((n) % 8)) & 1)
 
+// Sort keys are (oam.priority << 8 | subpriority) above an inverted y.
+#define SORT_KEY_Y_BITS 9
+#define SORT_KEY_BITS   (10 + SORT_KEY_Y_BITS)
+#define SORT_RADIX_BITS 5
+#define SORT_RADIX_MASK ((1 << SORT_RADIX_BITS) - 1)
+#define SORT_MAX_INSERTION_MOVES MAX_SPRITES
+
 
 struct SpriteCopyRequest
 {
@@ -280,7 +287,7 @@ u32 gOamMatrixAllocBitmap;
 u8 gReservedSpritePaletteCount;
 
 EWRAM_DATA struct Sprite gSprites[MAX_SPRITES + 1] = {0};
-EWRAM_DATA static u16 sSpritePriorities[MAX_SPRITES] = {0};
+EWRAM_DATA static u32 sSpriteSortKeys[MAX_SPRITES] = {0};
 EWRAM_DATA static u8 sSpriteOrder[MAX_SPRITES] = {0};
 EWRAM_DATA static bool8 sShouldProcessSpriteCopyRequests = 0;
 EWRAM_DATA static u8 sSpriteCopyRequestCount = 0;
@@ -310,6 +317,8 @@ void ResetSpriteData(void)
 void AnimateSprites(void)
 {
     u8 i;
+
+    FRAME_STAGE_START(FRAME_STAGE_ANIMATE_SPRITES);
     for (i = 0; i < MAX_SPRITES; i++)
     {
         struct Sprite *sprite = &gSprites[i];
@@ -322,11 +331,13 @@ void AnimateSprites(void)
                 AnimateSprite(sprite);
         }
     }
+    FRAME_STAGE_END(FRAME_STAGE_ANIMATE_SPRITES);
 }
 
 void BuildOamBuffer(void)
 {
     u8 temp;
+    FRAME_STAGE_START(FRAME_STAGE_BUILD_OAM);
     UpdateOamCoords();
     BuildSpritePriorities();
     SortSprites();
@@ -336,6 +347,7 @@ void BuildOamBuffer(void)
     CopyMatricesToOamBuffer();
     gMain.oamLoadDisabled = temp;
     sShouldProcessSpriteCopyRequests = TRUE;
+    FRAME_STAGE_END(FRAME_STAGE_BUILD_OAM);
 }
 
 void UpdateOamCoords(void)
@@ -360,6 +372,9 @@ void UpdateOamCoords(void)
     }
 }
 
+// Sprites are drawn in order of priority, then subpriority, then from the
+// bottom of the screen up. All three are packed into one key per sprite so
+// that a lower key means the sprite is drawn on top.
 void BuildSpritePriorities(void)
 {
     u16 i;
@@ -367,104 +382,95 @@ void BuildSpritePriorities(void)
     {
         struct Sprite *sprite = &gSprites[i];
         u16 priority = sprite->subpriority | (sprite->oam.priority << 8);
-        sSpritePriorities[i] = priority;
-    }
-}
-
-void SortSprites(void)
-{
-    u8 i;
-    for (i = 1; i < MAX_SPRITES; i++)
-    {
-        u8 j = i;
-        struct Sprite *sprite1 = &gSprites[sSpriteOrder[i - 1]];
-        struct Sprite *sprite2 = &gSprites[sSpriteOrder[i]];
-        u16 sprite1Priority = sSpritePriorities[sSpriteOrder[i - 1]];
-        u16 sprite2Priority = sSpritePriorities[sSpriteOrder[i]];
-        s16 sprite1Y = sprite1->oam.y;
-        s16 sprite2Y = sprite2->oam.y;
-
-        if (sprite1Y >= DISPLAY_HEIGHT)
-            sprite1Y = sprite1Y - 256;
+        s16 y = sprite->oam.y;
 
-        if (sprite2Y >= DISPLAY_HEIGHT)
-            sprite2Y = sprite2Y - 256;
+        if (y >= DISPLAY_HEIGHT)
+            y = y - 256;
 
-        if (sprite1->oam.affineMode == ST_OAM_AFFINE_DOUBLE
-         && sprite1->oam.size == ST_OAM_SIZE_3)
+        if (sprite->oam.affineMode == ST_OAM_AFFINE_DOUBLE
+         && sprite->oam.size == ST_OAM_SIZE_3)
         {
-            u32 shape = sprite1->oam.shape;
+            u32 shape = sprite->oam.shape;
             if (shape == ST_OAM_SQUARE || shape == ST_OAM_V_RECTANGLE)
             {
-                if (sprite1Y > 128)
-                    sprite1Y = sprite1Y - 256;
+                if (y > 128)
+                    y = y - 256;
             }
         }
 
-        if (sprite2->oam.affineMode == ST_OAM_AFFINE_DOUBLE
-         && sprite2->oam.size == ST_OAM_SIZE_3)
-        {
-            u32 shape = sprite2->oam.shape;
-            if (shape == ST_OAM_SQUARE || shape == ST_OAM_V_RECTANGLE)
-            {
-                if (sprite2Y > 128)
-                    sprite2Y = sprite2Y - 256;
-            }
-        }
+        // y is now between -127 and DISPLAY_HEIGHT - 1.
+        sSpriteSortKeys[i] = (priority << SORT_KEY_Y_BITS) | (DISPLAY_HEIGHT - 1 - y);
+    }
+}
+
+// Sorts sSpriteOrder by sort key. Sprites with equal keys stay in the order
+// they were drawn last frame, so they don't flicker. The order rarely changes
+// much between frames, which an insertion sort handles in close to one pass;
+// if too many sprites have moved it gives up and finishes with a stable LSD
+// radix sort, which costs the same however shuffled the sprites are.
+void SortSprites(void)
+{
+    u8 buffer[MAX_SPRITES];
+    u8 counts[1 << SORT_RADIX_BITS];
+    u8 *src = sSpriteOrder;
+    u8 *dest = buffer;
+    u32 shift, i, moves = 0;
+
+    for (i = 1; i < MAX_SPRITES; i++)
+    {
+        u8 index = sSpriteOrder[i];
+        u32 key = sSpriteSortKeys[index];
+        u32 j = i;
 
-        while (j > 0
-            && ((sprite1Priority > sprite2Priority)
-             || (sprite1Priority == sprite2Priority && sprite1Y < sprite2Y)))
+        while (j > 0 && sSpriteSortKeys[sSpriteOrder[j - 1]] > key)
         {
-            u8 temp = sSpriteOrder[j];
             sSpriteOrder[j] = sSpriteOrder[j - 1];
-            sSpriteOrder[j - 1] = temp;
-
-            // UB: If j equals 1, then j-- makes j equal 0.
-            // Then, sSpriteOrder[-1] gets accessed below.
-            // Although this doesn't result in a bug in the ROM,
-            // the behavior is undefined.
             j--;
-#ifdef UBFIX
-            if (j == 0)
-                break;
-#endif
+        }
+        sSpriteOrder[j] = index;
 
-            sprite1 = &gSprites[sSpriteOrder[j - 1]];
-            sprite2 = &gSprites[sSpriteOrder[j]];
-            sprite1Priority = sSpritePriorities[sSpriteOrder[j - 1]];
-            sprite2Priority = sSpritePriorities[sSpriteOrder[j]];
-            sprite1Y = sprite1->oam.y;
-            sprite2Y = sprite2->oam.y;
+        moves += i - j;
+        if (moves > SORT_MAX_INSERTION_MOVES)
+            break;
+    }
+    if (i >= MAX_SPRITES)
+        return;
 
-            if (sprite1Y >= DISPLAY_HEIGHT)
-                sprite1Y = sprite1Y - 256;
+    for (shift = 0; shift < SORT_KEY_BITS; shift += SORT_RADIX_BITS)
+    {
+        u32 total = 0;
+        u8 *temp;
 
-            if (sprite2Y >= DISPLAY_HEIGHT)
-                sprite2Y = sprite2Y - 256;
+        for (i = 0; i < ARRAY_COUNT(counts); i++)
+            counts[i] = 0;
+        for (i = 0; i < MAX_SPRITES; i++)
+            counts[(sSpriteSortKeys[src[i]] >> shift) & SORT_RADIX_MASK]++;
 
-            if (sprite1->oam.affineMode == ST_OAM_AFFINE_DOUBLE
-             && sprite1->oam.size == ST_OAM_SIZE_3)
-            {
-                u32 shape = sprite1->oam.shape;
-                if (shape == ST_OAM_SQUARE || shape == ST_OAM_V_RECTANGLE)
-                {
-                    if (sprite1Y > 128)
-                        sprite1Y = sprite1Y - 256;
-                }
-            }
+        // Every key has the same digit here, so this pass wouldn't move anything.
+        if (counts[(sSpriteSortKeys[src[0]] >> shift) & SORT_RADIX_MASK] == MAX_SPRITES)
+            continue;
 
-            if (sprite2->oam.affineMode == ST_OAM_AFFINE_DOUBLE
-             && sprite2->oam.size == ST_OAM_SIZE_3)
-            {
-                u32 shape = sprite2->oam.shape;
-                if (shape == ST_OAM_SQUARE || shape == ST_OAM_V_RECTANGLE)
-                {
-                    if (sprite2Y > 128)
-                        sprite2Y = sprite2Y - 256;
-                }
-            }
+        for (i = 0; i < ARRAY_COUNT(counts); i++)
+        {
+            u32 count = counts[i];
+            counts[i] = total;
+            total += count;
         }
+        for (i = 0; i < MAX_SPRITES; i++)
+        {
+            u8 index = src[i];
+            dest[counts[(sSpriteSortKeys[index] >> shift) & SORT_RADIX_MASK]++] = index;
+        }
+
+        temp = src;
+        src = dest;
+        dest = temp;
+    }
+
+    if (src != sSpriteOrder)
+    {
+        for (i = 0; i < MAX_SPRITES; i++)
+            sSpriteOrder[i] = src[i];
     }
 }
 
@@ -641,8 +647,10 @@ void ResetOamRange(u8 start, u8 end)
 
 void LoadOam(void)
 {
+    FRAME_STAGE_START(FRAME_STAGE_LOAD_OAM);
     if (!gMain.oamLoadDisabled)
         CpuCopy32(gMain.oamBuffer, (void *)OAM, sizeof(gMain.oamBuffer));
+    FRAME_STAGE_END(FRAME_STAGE_LOAD_OAM);
 }
 
 void ClearSpriteCopyRequests(void)
@@ -34,6 +34,9 @@ static u32 GetGlyphWidth_Normal(u16, bool32);
 static u32 GetGlyphWidth_Short(u16, bool32);
 static u32 GetGlyphWidth_Narrow(u16, bool32);
 static u32 GetGlyphWidth_SmallNarrow(u16, bool32);
+static void DrawGlyph(struct TextPrinter *, const struct TextGlyph *);
+static void PrintGlyph(struct TextPrinter *, u16);
+static u32 PrintGlyphRun(struct TextPrinter *, u32);
 
 static EWRAM_DATA struct TextPrinter sTempTextPrinter = {0};
 static EWRAM_DATA struct TextPrinter sTextPrinters[NUM_TEXT_PRINTERS] = {0};
@@ -43,6 +46,38 @@ static u16 sLastTextBgColor;
 static u16 sLastTextFgColor;
 static u16 sLastTextShadowColor;
 
+// Decompressed glyphs, keyed by font, glyph and the colors they were drawn in.
+// Each set holds two glyphs, and a miss replaces the least recently used one.
+#define GLYPH_CACHE_SETS 16
+#define GLYPH_CACHE_WAYS 2
+#define GLYPH_CACHE_VALID (1u << 31)
+
+struct GlyphCacheEntry
+{
+    u32 key;
+    struct TextGlyph glyph;
+};
+
+static EWRAM_DATA struct GlyphCacheEntry sGlyphCache[GLYPH_CACHE_SETS][GLYPH_CACHE_WAYS] = {0};
+static EWRAM_DATA u8 sGlyphCacheLruWay[GLYPH_CACHE_SETS] = {0};
+
+// Widths of strings in ROM, which never change. Strings in RAM are rewritten
+// by too many things (StringCopy, StringExpandPlaceholders, number
+// conversions...) to be invalidated reliably, so they are always measured,
+// as are ROM strings whose width depends on a placeholder.
+#define STRING_WIDTH_CACHE_SIZE 64
+
+struct StringWidthCacheEntry
+{
+    const u8 *str;
+    s16 letterSpacing;
+    u8 fontId;
+    u8 width;
+};
+
+static EWRAM_DATA struct StringWidthCacheEntry sStringWidthCache[STRING_WIDTH_CACHE_SIZE] = {0};
+static EWRAM_DATA struct StringWidthCacheStats sStringWidthCacheStats = {0};
+
 const struct FontInfo *gFonts;
 bool8 gDisableTextPrinters;
 struct TextGlyph gCurGlyph;
@@ -305,6 +340,7 @@ bool16 AddTextPrinter(struct TextPrinterTemplate *printerTemplate, u8 speed, voi
         {
             if (RenderFont(&sTempTextPrinter) == RENDER_FINISH)
                 break;
+            j += PrintGlyphRun(&sTempTextPrinter, 0x400 - 1 - j);
         }
 
         // All the text is rendered to the window but don't draw it yet.
@@ -367,6 +403,10 @@ void GenerateFontHalfRowLookupTable(u8 fgColor, u8 bgColor, u8 shadowColor)
 
     u16 *current = sFontHalfRowLookupTable;
 
+    // The table starts out zeroed, which is also what colors 0, 0, 0 generate.
+    if (fgColor == sLastTextFgColor && bgColor == sLastTextBgColor && shadowColor == sLastTextShadowColor)
+        return;
+
     sLastTextBgColor = bgColor;
     sLastTextFgColor = fgColor;
     sLastTextShadowColor = shadowColor;
@@ -570,83 +610,62 @@ static u8 GetLastTextColor(u8 colorType)
     }
 }
 
-inline static void GLYPH_COPY(u8 *windowTiles, u32 widthOffset, u32 j, u32 i, u32 *glyphPixels, s32 width, s32 height)
-{
-    u32 xAdd, yAdd, pixelData, bits, toOrr, dummyX;
-    u8 *dst;
-
-    xAdd = j + width;
-    yAdd = i + height;
-    dummyX = j;
-    for (; i < yAdd; i++)
-    {
-        pixelData = *glyphPixels++;
-        for (j = dummyX; j < xAdd; j++)
-        {
-            if ((toOrr = pixelData & 0xF))
-            {
-                dst = windowTiles + ((j / 8) * 32) + ((j % 8) / 2) + ((i / 8) * widthOffset) + ((i % 8) * 4);
-                bits = ((j & 1) * 4);
-                *dst = (toOrr << bits) | (*dst & (0xF0 >> bits));
-            }
-            pixelData >>= 4;
-        }
-    }
-}
-
-void CopyGlyphToWindow(struct TextPrinter *textPrinter)
+// Glyph rows are 8 pixels to a word, which lands in at most two tiles of the
+// window depending on x. Pixels of color 0 are left as they are.
+static void DrawGlyph(struct TextPrinter *textPrinter, const struct TextGlyph *glyph)
 {
     struct Window *window;
     struct WindowTemplate *template;
-    u32 *glyphPixels;
-    u32 currX, currY, widthOffset;
+    u32 currX, currY, widthOffset, half, row;
     s32 glyphWidth, glyphHeight;
-    u8 *windowTiles;
 
     window = &gWindows[textPrinter->printerTemplate.windowId];
     template = &window->window;
 
-    if ((glyphWidth = (template->width * 8) - textPrinter->printerTemplate.currentX) > gCurGlyph.width)
-        glyphWidth = gCurGlyph.width;
+    if ((glyphWidth = (template->width * 8) - textPrinter->printerTemplate.currentX) > glyph->width)
+        glyphWidth = glyph->width;
 
-    if ((glyphHeight = (template->height * 8) - textPrinter->printerTemplate.currentY) > gCurGlyph.height)
-        glyphHeight = gCurGlyph.height;
+    if ((glyphHeight = (template->height * 8) - textPrinter->printerTemplate.currentY) > glyph->height)
+        glyphHeight = glyph->height;
 
     currX = textPrinter->printerTemplate.currentX;
     currY = textPrinter->printerTemplate.currentY;
-    glyphPixels = gCurGlyph.gfxBufferTop;
-    windowTiles = window->tileData;
     widthOffset = template->width * 32;
 
-    if (glyphWidth < 9)
+    for (half = 0; half < 2 && (s32)(half * 8) < glyphWidth; half++)
     {
-        if (glyphHeight < 9)
-        {
-            GLYPH_COPY(windowTiles, widthOffset, currX, currY, glyphPixels, glyphWidth, glyphHeight);
-        }
-        else
-        {
-            GLYPH_COPY(windowTiles, widthOffset, currX, currY, glyphPixels, glyphWidth, 8);
-            GLYPH_COPY(windowTiles, widthOffset, currX, currY + 8, glyphPixels + 16, glyphWidth, glyphHeight - 8);
-        }
-    }
-    else
-    {
-        if (glyphHeight < 9)
-        {
-            GLYPH_COPY(windowTiles, widthOffset, currX, currY, glyphPixels, 8, glyphHeight);
-            GLYPH_COPY(windowTiles, widthOffset, currX + 8, currY, glyphPixels + 8, glyphWidth - 8, glyphHeight);
-        }
-        else
+        u32 x = currX + half * 8;
+        u32 shift = (x % 8) * 4;
+        u32 columns = glyphWidth - half * 8;
+        u32 columnMask = columns < 8 ? (1 << (columns * 4)) - 1 : 0xFFFFFFFF;
+        u8 *tiles = window->tileData + (x / 8) * 32;
+
+        for (row = 0; (s32)row < glyphHeight; row++)
         {
-            GLYPH_COPY(windowTiles, widthOffset, currX, currY, glyphPixels, 8, 8);
-            GLYPH_COPY(windowTiles, widthOffset, currX + 8, currY, glyphPixels + 8, glyphWidth - 8, 8);
-            GLYPH_COPY(windowTiles, widthOffset, currX, currY + 8, glyphPixels + 16, 8, glyphHeight - 8);
-            GLYPH_COPY(windowTiles, widthOffset, currX + 8, currY + 8, glyphPixels + 24, glyphWidth - 8, glyphHeight - 8);
+            u32 y = currY + row;
+            u32 pixels = (row < 8 ? glyph->gfxBufferTop : glyph->gfxBufferBottom)[half * 8 + row % 8];
+            u32 mask = (pixels | (pixels >> 1) | (pixels >> 2) | (pixels >> 3)) & 0x11111111 & columnMask;
+            u32 *dst;
+
+            if (mask == 0)
+                continue;
+
+            mask *= 0xF;
+            pixels &= mask;
+            dst = (u32 *)(tiles + (y / 8) * widthOffset + (y % 8) * 4);
+            if ((mask << shift) != 0)
+                dst[0] = (dst[0] & ~(mask << shift)) | (pixels << shift);
+            if (shift != 0 && (mask >> (32 - shift)) != 0)
+                dst[8] = (dst[8] & ~(mask >> (32 - shift))) | (pixels >> (32 - shift));
         }
     }
 }
 
+void CopyGlyphToWindow(struct TextPrinter *textPrinter)
+{
+    DrawGlyph(textPrinter, &gCurGlyph);
+}
+
 void ClearTextSpan(struct TextPrinter *textPrinter, u32 width)
 {
     struct Window *window;
@@ -1121,49 +1140,7 @@ static u16 RenderText(struct TextPrinter *textPrinter)
             return RENDER_FINISH;
         }
 
-        switch (subStruct->fontId)
-        {
-        case FONT_SMALL:
-            DecompressGlyph_Small(currChar, textPrinter->japanese);
-            break;
-        case FONT_NORMAL:
-            DecompressGlyph_Normal(currChar, textPrinter->japanese);
-            break;
-        case FONT_SHORT:
-        case FONT_SHORT_COPY_1:
-        case FONT_SHORT_COPY_2:
-        case FONT_SHORT_COPY_3:
-            DecompressGlyph_Short(currChar, textPrinter->japanese);
-            break;
-        case FONT_NARROW:
-            DecompressGlyph_Narrow(currChar, textPrinter->japanese);
-            break;
-        case FONT_SMALL_NARROW:
-            DecompressGlyph_SmallNarrow(currChar, textPrinter->japanese);
-            break;
-        case FONT_BRAILLE:
-            break;
-        }
-
-        CopyGlyphToWindow(textPrinter);
-
-        if (textPrinter->minLetterSpacing)
-        {
-            textPrinter->printerTemplate.currentX += gCurGlyph.width;
-            width = textPrinter->minLetterSpacing - gCurGlyph.width;
-            if (width > 0)
-            {
-                ClearTextSpan(textPrinter, width);
-                textPrinter->printerTemplate.currentX += width;
-            }
-        }
-        else
-        {
-            if (textPrinter->japanese)
-                textPrinter->printerTemplate.currentX += (gCurGlyph.width + textPrinter->printerTemplate.letterSpacing);
-            else
-                textPrinter->printerTemplate.currentX += gCurGlyph.width;
-        }
+        PrintGlyph(textPrinter, currChar);
         return RENDER_PRINT;
     case RENDER_STATE_WAIT:
         if (TextPrinterWait(textPrinter))
@@ -1224,6 +1201,127 @@ static u16 RenderText(struct TextPrinter *textPrinter)
     return RENDER_FINISH;
 }
 
+static bool32 DecompressGlyph(u32 fontId, u16 glyphId, bool32 isJapanese)
+{
+    switch (fontId)
+    {
+    case FONT_SMALL:
+        DecompressGlyph_Small(glyphId, isJapanese);
+        return TRUE;
+    case FONT_NORMAL:
+        DecompressGlyph_Normal(glyphId, isJapanese);
+        return TRUE;
+    case FONT_SHORT:
+    case FONT_SHORT_COPY_1:
+    case FONT_SHORT_COPY_2:
+    case FONT_SHORT_COPY_3:
+        DecompressGlyph_Short(glyphId, isJapanese);
+        return TRUE;
+    case FONT_NARROW:
+        DecompressGlyph_Narrow(glyphId, isJapanese);
+        return TRUE;
+    case FONT_SMALL_NARROW:
+        DecompressGlyph_SmallNarrow(glyphId, isJapanese);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+// Returns the glyph in the current text colors, from the cache if it's there.
+// On a hit only gCurGlyph's size is updated, not its pixels.
+static const struct TextGlyph *LoadGlyph(u32 fontId, u16 glyphId, bool32 isJapanese)
+{
+    struct GlyphCacheEntry *set;
+    u32 key, setId, way;
+
+    // The short font copies share their glyphs.
+    if (fontId >= FONT_SHORT_COPY_1 && fontId <= FONT_SHORT_COPY_3)
+        fontId = FONT_SHORT;
+
+    if (glyphId >= 0x200 || (sLastTextFgColor | sLastTextBgColor | sLastTextShadowColor) >= 0x10)
+    {
+        DecompressGlyph(fontId, glyphId, isJapanese);
+        return &gCurGlyph;
+    }
+
+    key = GLYPH_CACHE_VALID
+        | glyphId
+        | (isJapanese << 9)
+        | (fontId << 10)
+        | (sLastTextFgColor << 14)
+        | (sLastTextBgColor << 18)
+        | (sLastTextShadowColor << 22);
+    setId = (glyphId ^ (glyphId >> 4) ^ fontId) % GLYPH_CACHE_SETS;
+    set = sGlyphCache[setId];
+
+    for (way = 0; way < GLYPH_CACHE_WAYS; way++)
+    {
+        if (set[way].key == key)
+        {
+            sGlyphCacheLruWay[setId] = way ^ 1;
+            gCurGlyph.width = set[way].glyph.width;
+            gCurGlyph.height = set[way].glyph.height;
+            return &set[way].glyph;
+        }
+    }
+
+    if (DecompressGlyph(fontId, glyphId, isJapanese))
+    {
+        way = sGlyphCacheLruWay[setId];
+        set[way].key = key;
+        set[way].glyph = gCurGlyph;
+        sGlyphCacheLruWay[setId] = way ^ 1;
+    }
+    return &gCurGlyph;
+}
+
+static void PrintGlyph(struct TextPrinter *textPrinter, u16 currChar)
+{
+    struct TextPrinterSubStruct *subStruct = (struct TextPrinterSubStruct *)(&textPrinter->subStructFields);
+    s32 width;
+
+    DrawGlyph(textPrinter, LoadGlyph(subStruct->fontId, currChar, textPrinter->japanese));
+
+    if (textPrinter->minLetterSpacing)
+    {
+        textPrinter->printerTemplate.currentX += gCurGlyph.width;
+        width = textPrinter->minLetterSpacing - gCurGlyph.width;
+        if (width > 0)
+        {
+            ClearTextSpan(textPrinter, width);
+            textPrinter->printerTemplate.currentX += width;
+        }
+    }
+    else
+    {
+        if (textPrinter->japanese)
+            textPrinter->printerTemplate.currentX += (gCurGlyph.width + textPrinter->printerTemplate.letterSpacing);
+        else
+            textPrinter->printerTemplate.currentX += gCurGlyph.width;
+    }
+}
+
+// For text that is printed all at once: prints every character up to the next
+// control code without going back through RenderText for each one. Returns the
+// number of characters printed, at most maxGlyphs.
+static u32 PrintGlyphRun(struct TextPrinter *textPrinter, u32 maxGlyphs)
+{
+    const u8 *str = textPrinter->printerTemplate.currentChar;
+    u32 count = 0;
+
+    if (textPrinter->state != RENDER_STATE_HANDLE_CHAR
+     || gFonts[textPrinter->printerTemplate.fontId].fontFunction == FontFunc_Braille)
+        return 0;
+
+    while (count < maxGlyphs && *str < CHAR_KEYPAD_ICON)
+    {
+        PrintGlyph(textPrinter, *str++);
+        count++;
+    }
+    textPrinter->printerTemplate.currentChar = str;
+    return count;
+}
+
 // Unused
 static u32 GetStringWidthFixedWidthFont(const u8 *str, u8 fontId, u8 letterSpacing)
 {
@@ -1327,7 +1425,7 @@ static u32 (*GetFontWidthFunc(u8 fontId))(u16, bool32)
     return NULL;
 }
 
-s32 GetStringWidth(u8 fontId, const u8 *str, s16 letterSpacing)
+static s32 MeasureStringWidth(u8 fontId, const u8 *str, s16 letterSpacing, bool32 *usesPlaceholder)
 {
     bool8 isJapanese;
     int minGlyphWidth;
@@ -1379,6 +1477,7 @@ s32 GetStringWidth(u8 fontId, const u8 *str, s16 letterSpacing)
                 return 0;
             }
         case CHAR_DYNAMIC:
+            *usesPlaceholder = TRUE;
             if (bufferPointer == NULL)
                 bufferPointer = DynamicPlaceholderTextUtil_GetPlaceholderPtr(*++str);
             while (*bufferPointer != EOS)
@@ -1499,6 +1598,51 @@ s32 GetStringWidth(u8 fontId, const u8 *str, s16 letterSpacing)
     return width;
 }
 
+s32 GetStringWidth(u8 fontId, const u8 *str, s16 letterSpacing)
+{
+    struct StringWidthCacheEntry *entry;
+    bool32 usesPlaceholder = FALSE;
+    s32 width;
+
+    if ((u32)str < ROM_START || (u32)str >= ROM_END)
+    {
+        sStringWidthCacheStats.uncached++;
+        return MeasureStringWidth(fontId, str, letterSpacing, &usesPlaceholder);
+    }
+
+    entry = &sStringWidthCache[((u32)str ^ ((u32)str >> 6) ^ fontId) % STRING_WIDTH_CACHE_SIZE];
+    if (entry->str == str && entry->fontId == fontId && entry->letterSpacing == letterSpacing)
+    {
+        sStringWidthCacheStats.hits++;
+        return entry->width;
+    }
+
+    width = MeasureStringWidth(fontId, str, letterSpacing, &usesPlaceholder);
+    if (usesPlaceholder || width > 0xFF)
+    {
+        sStringWidthCacheStats.uncached++;
+    }
+    else
+    {
+        sStringWidthCacheStats.misses++;
+        entry->str = str;
+        entry->letterSpacing = letterSpacing;
+        entry->fontId = fontId;
+        entry->width = width;
+    }
+    return width;
+}
+
+void GetStringWidthCacheStats(struct StringWidthCacheStats *stats)
+{
+    *stats = sStringWidthCacheStats;
+}
+
+void ResetStringWidthCacheStats(void)
+{
+    memset(&sStringWidthCacheStats, 0, sizeof(sStringWidthCacheStats));
+}
+
 u8 RenderTextHandleBold(u8 *pixels, u8 fontId, u8 *str)
 {
     u8 shadowColor;
@@ -132,6 +132,13 @@ struct TextGlyph
     u8 height;
 };
 
+struct StringWidthCacheStats
+{
+    u32 hits;
+    u32 misses;
+    u32 uncached; // strings in RAM, or using placeholders
+};
+
 extern TextFlags gTextFlags;
 
 extern u8 gDisableTextPrinters;
@@ -157,6 +164,8 @@ bool16 TextPrinterWaitWithDownArrow(struct TextPrinter *textPrinter);
 bool16 TextPrinterWait(struct TextPrinter *textPrinter);
 void DrawDownArrow(u8 windowId, u16 x, u16 y, u8 bgColor, bool8 drawArrow, u8 *counter, u8 *yCoordIndex);
 s32 GetStringWidth(u8 fontId, const u8 *str, s16 letterSpacing);
+void GetStringWidthCacheStats(struct StringWidthCacheStats *stats);
+void ResetStringWidthCacheStats(void);
 u8 RenderTextHandleBold(u8 *pixels, u8 fontId, u8 *str);
 u8 DrawKeypadIcon(u8 windowId, u8 keypadIconId, u16 x, u16 y);
 u8 GetKeypadIconTileOffset(u8 keypadIconId);
@@ -81,6 +81,7 @@ bool16 InitWindows(const struct WindowTemplate *templates)
 
                 gWindowBgTilemapBuffers[bgLayer] = allocatedTilemapBuffer;
                 SetBgTilemapBuffer(bgLayer, allocatedTilemapBuffer);
+                EnableBgTilemapDirtyTracking(bgLayer);
             }
         }
 
@@ -156,6 +157,7 @@ u16 AddWindow(const struct WindowTemplate *template)
 
             gWindowBgTilemapBuffers[bgLayer] = allocatedTilemapBuffer;
             SetBgTilemapBuffer(bgLayer, allocatedTilemapBuffer);
+            EnableBgTilemapDirtyTracking(bgLayer);
         }
     }
 
@@ -18,4 +18,11 @@
 // Pokémon Debug
 #define DEBUG_POKEMON_MENU              TRUE    // Enables a debug menu for pokemon sprites and icons, accessed by pressing SELECT in the summary screen.
 
+// Heap Debug
+#define DEBUG_HEAP_CALLSITES            FALSE   // If set to TRUE, Alloc and AllocZeroed count their calls per return address. The counts are printed by the Heap Stats option of the Utilities debug menu when printf debugging is enabled.
+
+// Profiling
+#define DEBUG_FRAME_PROFILING           FALSE   // If set to TRUE, every frame the main loop and VBlank interrupt are timed in stages with timers 1 and 2. The Frame Profile option of the Utilities debug menu sums up the last frames, and prints them and the last frames that went over budget when printf debugging is enabled.
+#define DEBUG_TASK_PROFILING            FALSE   // If set to TRUE, RunTasks times every task function with timers 1 and 2. The busiest one is shown by the Task Stats option of the Utilities debug menu, and all of them are printed when printf debugging is enabled.
+
 #endif // GUARD_CONFIG_DEBUG_H
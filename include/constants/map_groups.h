@@ -592,5 +592,6 @@
 #define MAP_ROUTE124_DIVING_TREASURE_HUNTERS_HOUSE (0 | (33 << 8))
 
 #define MAP_GROUPS_COUNT 34
+#define MAX_MAPS_IN_GROUP 108
 
 #endif // GUARD_CONSTANTS_MAP_GROUPS_H
@@ -15,6 +15,8 @@ extern struct CameraObject gFieldCamera;
 extern u16 gTotalCameraPixelOffsetX;
 extern u16 gTotalCameraPixelOffsetY;
 
+void InitMetatileDrawCache(void);
+void FreeMetatileDrawCache(void);
 void DrawWholeMapView(void);
 void CurrentMapDrawMetatileAt(int x, int y);
 void GetCameraOffsetWithPan(s16 *x, s16 *y);
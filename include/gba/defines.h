@@ -26,6 +26,8 @@
 #define EWRAM_END   (EWRAM_START + 0x40000)
 #define IWRAM_START 0x03000000
 #define IWRAM_END   (IWRAM_START + 0x8000)
+#define ROM_START   0x08000000
+#define ROM_END     (ROM_START + 0x2000000)
 
 #define PLTT      0x5000000
 #define PLTT_SIZE 0x400
@@ -40,6 +40,46 @@ struct Main
     /*0x439*/ u8 anyLinkBattlerHasFrontierPass:1;
 };
 
+// CPU cycles from one VBlank to the next
+#define CYCLES_PER_FRAME 280896
+
+// Parts of a frame timed by the frame profiler. A stage includes the stages
+// called from it, so callback 2 includes the tasks and sprites, and an
+// interrupt that lands in the middle of a stage counts towards it too.
+enum {
+    FRAME_STAGE_LINK,
+    FRAME_STAGE_CALLBACK1,
+    FRAME_STAGE_CALLBACK2,
+    FRAME_STAGE_TASKS,
+    FRAME_STAGE_ANIMATE_SPRITES,
+    FRAME_STAGE_BUILD_OAM,
+    FRAME_STAGE_VBLANK,
+    FRAME_STAGE_VBLANK_CALLBACK,
+    FRAME_STAGE_LOAD_OAM,
+    FRAME_STAGE_TRANSFER_PLTT,
+    FRAME_STAGE_DMA3,
+    FRAME_STAGE_SOUND,
+    NUM_FRAME_STAGES,
+};
+
+#if DEBUG_FRAME_PROFILING == TRUE
+#define FRAME_STAGE_START(stage) StartFrameStage(stage)
+#define FRAME_STAGE_END(stage) EndFrameStage(stage)
+#else
+#define FRAME_STAGE_START(stage)
+#define FRAME_STAGE_END(stage)
+#endif
+
+// The frames kept by the frame profiler. Only recorded when
+// DEBUG_FRAME_PROFILING is enabled.
+struct FrameProfileStats
+{
+    u16 frames;
+    u16 overruns; // frames over CYCLES_PER_FRAME since boot
+    u32 averageCycles;
+    u32 peakCycles;
+};
+
 #define GAME_CODE_LENGTH 4
 extern const u8 gGameVersion;
 extern const u8 gGameLanguage;
@@ -72,5 +112,12 @@ void RestoreSerialTimer3IntrHandlers(void);
 void StartTimer1(void);
 void SeedRngAndSetTrainerId(void);
 u16 GetGeneratedTrainerIdLower(void);
+void StartCycleCounter(void);
+bool32 IsCycleCounterRunning(void);
+u32 GetCycleCount(void);
+void StartFrameStage(u32 stage);
+void EndFrameStage(u32 stage);
+void GetFrameProfileStats(struct FrameProfileStats *stats);
+void PrintFrameProfile(void);
 
 #endif // GUARD_MAIN_H
@@ -230,6 +230,17 @@ struct Pokemon
     u16 spDefense;
 };
 
+// A decrypted copy of a BoxPokemon, for reading or writing several fields at
+// once. See BeginBoxMonAccess.
+struct BoxMonAccess
+{
+    struct BoxPokemon *source;
+    struct BoxPokemon boxMon;
+    bool8 isBadChecksum;
+    bool8 modified;
+    bool8 secureModified;
+};
+
 struct MonSpritesGfxManager
 {
     u32 numSprites:4;
@@ -435,6 +446,7 @@ void CalculateMonStats(struct Pokemon *mon);
 void BoxMonToMon(const struct BoxPokemon *src, struct Pokemon *dest);
 u8 GetLevelFromMonExp(struct Pokemon *mon);
 u8 GetLevelFromBoxMonExp(struct BoxPokemon *boxMon);
+u8 GetLevelFromBoxMonAccessExp(struct BoxMonAccess *access);
 u16 GiveMoveToMon(struct Pokemon *mon, u16 move);
 u16 GiveMoveToBattleMon(struct BattlePokemon *mon, u16 move);
 void SetMonMoveSlot(struct Pokemon *mon, u16 move, u8 slot);
@@ -463,6 +475,10 @@ u32 GetBoxMonData();
 
 void SetMonData(struct Pokemon *mon, s32 field, const void *dataArg);
 void SetBoxMonData(struct BoxPokemon *boxMon, s32 field, const void *dataArg);
+void BeginBoxMonAccess(struct BoxMonAccess *access, struct BoxPokemon *boxMon);
+u32 GetBoxMonAccessData(struct BoxMonAccess *access, s32 field, u8 *data);
+void SetBoxMonAccessData(struct BoxMonAccess *access, s32 field, const void *data);
+void EndBoxMonAccess(struct BoxMonAccess *access);
 void CopyMon(void *dest, void *src, size_t size);
 u8 GiveMonToPlayer(struct Pokemon *mon);
 u8 SendMonToPC(struct Pokemon* mon);
@@ -8,6 +8,9 @@ extern u32 gRng2Value;
 u16 Random(void);
 u16 Random2(void);
 
+//Returns a pseudorandom number in [0, range) without the bias of Random() % range
+u16 RandomBelow(u16 range);
+
 //Returns a 32-bit pseudorandom number
 #define Random32() (Random() | (Random() << 16))
 
@@ -5,7 +5,8 @@
 #define TAIL_SENTINEL 0xFF
 #define TASK_NONE TAIL_SENTINEL
 
-#define NUM_TASKS 16
+// Task ids must stay below HEAD_SENTINEL.
+#define NUM_TASKS 32
 #define NUM_TASK_DATA 16
 
 typedef void (*TaskFunc)(u8 taskId);
@@ -20,6 +21,25 @@ struct Task
     s16 data[NUM_TASK_DATA];
 };
 
+#define TASK_PROFILE_COUNT 32
+
+struct TaskStats
+{
+    u8 activeTasks;
+    u8 peakActiveTasks;
+    u16 failedCreates; // CreateTask calls made with every task in use
+};
+
+// The time spent in one task function since the last ResetTaskStats.
+// Only recorded when DEBUG_TASK_PROFILING is enabled.
+struct TaskProfile
+{
+    TaskFunc func;
+    u32 calls;
+    u32 totalCycles;
+    u32 peakCycles;
+};
+
 extern struct Task gTasks[];
 
 void ResetTasks(void);
@@ -34,5 +54,8 @@ u8 FindTaskIdByFunc(TaskFunc func);
 u8 GetTaskCount(void);
 void SetWordTaskArg(u8 taskId, u8 dataElem, u32 value);
 u32 GetWordTaskArg(u8 taskId, u8 dataElem);
+void GetTaskStats(struct TaskStats *stats);
+const struct TaskProfile *GetTaskProfiles(void);
+void ResetTaskStats(void);
 
 #endif // GUARD_TASK_H
@@ -6,6 +6,19 @@
 extern const u8 gMiscBlank_Gfx[]; // unused in Emerald
 extern const u32 gBitTable[];
 
+// The result of blending each 5-bit channel value with one color at one
+// coefficient, already shifted into place: a blended color is
+// r[GET_R(c)] | g[GET_G(c)] | b[GET_B(c)].
+struct BlendLut
+{
+    u16 r[32];
+    u16 g[32];
+    u16 b[32];
+    u16 color;
+    u8 coeff;
+    bool8 valid;
+};
+
 u8 CreateInvisibleSpriteWithCallback(void (*)(struct Sprite *));
 void StoreWordInTwoHalfwords(u16 *, u32);
 void LoadWordFromTwoHalfwords(u16 *, u32 *);
@@ -14,6 +27,8 @@ u16 CalcCRC16(const u8 *data, s32 length);
 u16 CalcCRC16WithTable(const u8 *data, u32 length);
 u32 CalcByteArraySum(const u8 *data, u32 length);
 void BlendPalette(u16 palOffset, u16 numEntries, u8 coeff, u16 blendColor);
+const struct BlendLut *GetBlendLut(u8 coeff, u16 blendColor);
+void BlendPaletteWithLut(u16 palOffset, u16 numEntries, u8 coeff, u16 blendColor);
 void DoBgAffineSet(struct BgAffineDstData *dest, u32 texX, u32 texY, s16 scrX, s16 scrY, s16 sx, s16 sy, u16 alpha);
 void CopySpriteTiles(u8 shape, u8 size, u8 *tiles, u16 *tilemap, u8 *output);
 
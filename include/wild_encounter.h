@@ -27,6 +27,7 @@ struct WildPokemonHeader
 };
 
 extern const struct WildPokemonHeader gWildMonHeaders[];
+extern const u16 gWildMonHeadersByMap[MAP_GROUPS_COUNT][MAX_MAPS_IN_GROUP];
 extern bool8 gIsFishingEncounter;
 extern bool8 gIsSurfingEncounter;
 
@@ -1,14 +1,39 @@
 # JSON files are run through jsonproc, which is a tool that converts JSON data to an output file
 # based on an Inja template. https://github.com/pantor/inja
 
-AUTO_GEN_TARGETS += $(DATA_SRC_SUBDIR)/wild_encounters.h
-$(DATA_SRC_SUBDIR)/wild_encounters.h: $(DATA_SRC_SUBDIR)/wild_encounters.json $(DATA_SRC_SUBDIR)/wild_encounters.json.txt
-	$(JSONPROC) $^ $@
+# $(call JSONPROC_JOB,json,template,output)
+# Every job is rendered by a single jsonproc run over a manifest. jsonproc only rewrites
+# outputs whose contents changed, so the stamp records when it last ran.
+define JSONPROC_JOB
+JSONPROC_JOBS += $1 $2 $3
+JSONPROC_INPUTS += $1 $2
+JSONPROC_OUTPUTS += $3
+endef
+
+JSONPROC_JOBS :=
+JSONPROC_INPUTS :=
+JSONPROC_OUTPUTS :=
+JSONPROC_STAMP := $(DATA_SRC_SUBDIR)/jsonproc.stamp
+JSONPROC_MANIFEST := $(DATA_SRC_SUBDIR)/jsonproc_jobs.txt
+
+$(eval $(call JSONPROC_JOB,$(DATA_SRC_SUBDIR)/wild_encounters.json,$(DATA_SRC_SUBDIR)/wild_encounters.json.txt,$(DATA_SRC_SUBDIR)/wild_encounters.h))
 
 $(C_BUILDDIR)/wild_encounter.o: c_dep += $(DATA_SRC_SUBDIR)/wild_encounters.h
 
-AUTO_GEN_TARGETS += $(DATA_SRC_SUBDIR)/region_map/region_map_entries.h
-$(DATA_SRC_SUBDIR)/region_map/region_map_entries.h: $(DATA_SRC_SUBDIR)/region_map/region_map_sections.json $(DATA_SRC_SUBDIR)/region_map/region_map_sections.json.txt
-	$(JSONPROC) $^ $@
+$(eval $(call JSONPROC_JOB,$(DATA_SRC_SUBDIR)/region_map/region_map_sections.json,$(DATA_SRC_SUBDIR)/region_map/region_map_sections.json.txt,$(DATA_SRC_SUBDIR)/region_map/region_map_entries.h))
 
 $(C_BUILDDIR)/region_map.o: c_dep += $(DATA_SRC_SUBDIR)/region_map/region_map_entries.h
+
+AUTO_GEN_TARGETS += $(JSONPROC_OUTPUTS) $(JSONPROC_STAMP) $(JSONPROC_MANIFEST)
+
+# Run again if an output was deleted while the stamp was kept.
+ifneq ($(sort $(wildcard $(JSONPROC_OUTPUTS))),$(sort $(JSONPROC_OUTPUTS)))
+$(shell rm -f $(JSONPROC_STAMP))
+endif
+
+$(JSONPROC_STAMP): $(JSONPROC_INPUTS)
+	@printf '%s %s %s\n' $(JSONPROC_JOBS) > $(JSONPROC_MANIFEST)
+	$(JSONPROC) -m $(JSONPROC_MANIFEST)
+	@touch $@
+
+$(JSONPROC_OUTPUTS): $(JSONPROC_STAMP) ;
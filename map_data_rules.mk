@@ -13,19 +13,27 @@ $(DATA_ASM_BUILDDIR)/maps.o: $(DATA_ASM_SUBDIR)/maps.s $(LAYOUTS_DIR)/layouts.in
 $(DATA_ASM_BUILDDIR)/map_events.o: $(DATA_ASM_SUBDIR)/map_events.s $(MAPS_DIR)/events.inc $(MAP_EVENTS)
 	$(PREPROC) $< charmap.txt | $(CPP) -I include - | $(AS) $(ASFLAGS) -o $@
 
-$(MAPS_DIR)/%/header.inc: $(MAPS_DIR)/%/map.json
-	$(MAPJSON) map emerald $< $(LAYOUTS_DIR)/layouts.json
-$(MAPS_DIR)/%/events.inc: $(MAPS_DIR)/%/header.inc ;
-$(MAPS_DIR)/%/connections.inc: $(MAPS_DIR)/%/events.inc ;
-
-$(MAPS_DIR)/groups.inc: $(MAPS_DIR)/map_groups.json
-	$(MAPJSON) groups emerald $<
-$(MAPS_DIR)/connections.inc: $(MAPS_DIR)/groups.inc ;
-$(MAPS_DIR)/events.inc: $(MAPS_DIR)/connections.inc ;
-$(MAPS_DIR)/headers.inc: $(MAPS_DIR)/events.inc ;
-include/constants/map_groups.h: $(MAPS_DIR)/headers.inc ;
-
-$(LAYOUTS_DIR)/layouts.inc: $(LAYOUTS_DIR)/layouts.json
-	$(MAPJSON) layouts emerald $<
-$(LAYOUTS_DIR)/layouts_table.inc: $(LAYOUTS_DIR)/layouts.inc ;
-include/constants/layouts.h: $(LAYOUTS_DIR)/layouts_table.inc ;
+# mapjson's "all" mode regenerates every map, group and layout file in one run.
+# It only rewrites files whose contents changed, so the stamp records when it last
+# ran, and its depfile lists every map.json it read.
+MAPJSON_STAMP := $(MAPS_DIR)/mapjson.stamp
+MAPJSON_OUTPUTS := $(MAP_HEADERS) $(MAP_EVENTS) $(MAP_CONNECTIONS) \
+	$(MAPS_DIR)/groups.inc $(MAPS_DIR)/connections.inc $(MAPS_DIR)/events.inc $(MAPS_DIR)/headers.inc \
+	$(LAYOUTS_DIR)/layouts.inc $(LAYOUTS_DIR)/layouts_table.inc \
+	include/constants/map_groups.h include/constants/layouts.h
+
+# Run again if an output was deleted while the stamp was kept.
+ifneq ($(sort $(wildcard $(MAPJSON_OUTPUTS))),$(sort $(MAPJSON_OUTPUTS)))
+$(shell rm -f $(MAPJSON_STAMP))
+endif
+
+$(MAPJSON_STAMP): $(MAPS_DIR)/map_groups.json $(LAYOUTS_DIR)/layouts.json
+	$(MAPJSON) all emerald $(MAPS_DIR)/map_groups.json $(LAYOUTS_DIR)/layouts.json $@
+
+-include $(MAPJSON_STAMP).d
+
+$(MAP_HEADERS) $(MAP_EVENTS) $(MAP_CONNECTIONS): $(MAPJSON_STAMP) ;
+$(MAPS_DIR)/groups.inc $(MAPS_DIR)/connections.inc $(MAPS_DIR)/events.inc $(MAPS_DIR)/headers.inc: $(MAPJSON_STAMP) ;
+include/constants/map_groups.h: $(MAPJSON_STAMP) ;
+$(LAYOUTS_DIR)/layouts.inc $(LAYOUTS_DIR)/layouts_table.inc: $(MAPJSON_STAMP) ;
+include/constants/layouts.h: $(MAPJSON_STAMP) ;
@@ -218,10 +218,12 @@ u8 BattleAI_ChooseMoveOrAction(void)
     u32 savedCurrentMove = gCurrentMove;
     u8 ret;
 
+    BeginBattlerEffectCache();
     if (!(gBattleTypeFlags & BATTLE_TYPE_DOUBLE))
         ret = ChooseMoveOrAction_Singles();
     else
         ret = ChooseMoveOrAction_Doubles();
+    EndBattlerEffectCache();
 
     // Clear protect structures, some flags may be set during AI calcs
     // e.g. pranksterElevated from GetMovePriority
@@ -342,6 +344,8 @@ void GetAiLogicData(void)
     if (!(gBattleTypeFlags & BATTLE_TYPE_HAS_AI) && !IsWildMonSmart())
         return;
 
+    BeginBattlerEffectCache();
+
     // get/assume all battler data
     for (i = 0; i < gBattlersCount; i++)
     {
@@ -382,6 +386,8 @@ void GetAiLogicData(void)
             }
         }
     }
+
+    EndBattlerEffectCache();
 }
 
 static u8 ChooseMoveOrAction_Singles(void)
@@ -548,6 +548,8 @@ void SetBattlerData(u8 battlerId)
         struct Pokemon *illusionMon;
         u32 i;
 
+        InvalidateBattlerEffectCache();
+
         // Use the known battler's ability.
         if (BATTLE_HISTORY->abilities[battlerId] != ABILITY_NONE)
             gBattleMons[battlerId].ability = BATTLE_HISTORY->abilities[battlerId];
@@ -580,6 +582,7 @@ void RestoreBattlerData(u8 battlerId)
     {
         u32 i;
 
+        InvalidateBattlerEffectCache();
         gBattleMons[battlerId].ability = AI_THINKING_STRUCT->saved[battlerId].ability;
         gBattleMons[battlerId].item = AI_THINKING_STRUCT->saved[battlerId].heldItem;
         gBattleMons[battlerId].species = AI_THINKING_STRUCT->saved[battlerId].species;
@@ -3278,10 +3281,12 @@ s32 AI_CalcPartyMonDamage(u16 move, u8 battlerAtk, u8 battlerDef, struct Pokemon
         battleMons[i] = gBattleMons[i];
 
     PokemonToBattleMon(mon, &gBattleMons[battlerAtk]);
+    InvalidateBattlerEffectCache();
     dmg = AI_CalcDamage(move, battlerAtk, battlerDef, &effectiveness, FALSE);
 
     for (i = 0; i < MAX_BATTLERS_COUNT; i++)
         gBattleMons[i] = battleMons[i];
+    InvalidateBattlerEffectCache();
 
     Free(battleMons);
 
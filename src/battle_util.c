@@ -56,6 +56,7 @@ functions instead of at the top of the file with the other declarations.
 */
 
 static bool32 TryRemoveScreens(u8 battler);
+static u32 GetBattlerItemHoldEffect(u8 battlerId);
 static bool32 IsUnnerveAbilityOnOpposingSide(u8 battlerId);
 static u8 GetFlingPowerFromItemId(u16 itemId);
 static void SetRandomMultiHitCounter();
@@ -6069,12 +6070,75 @@ bool32 IsNeutralizingGasOnField(void)
     return FALSE;
 }
 
-u32 GetBattlerAbility(u8 battlerId)
+// Damage calcs and AI scoring look up the same battlers' abilities and hold
+// effects hundreds of times without changing them. Between
+// BeginBattlerEffectCache and EndBattlerEffectCache, the parts of
+// GetBattlerAbility and GetBattlerHoldEffect that only depend on the battler
+// itself are worked out once. Mold Breaker, Embargo and Magic Room are still
+// checked on every call, as they're cheap or depend on the attacker and move.
+// Anything that changes an ability or item while the cache is active must
+// call InvalidateBattlerEffectCache.
+#define BATTLER_CACHE_ABILITY     (1 << 0)
+#define BATTLER_CACHE_HOLD_EFFECT (1 << 1)
+
+struct BattlerEffectCache
+{
+    u16 ability; // after Gastro Acid and Neutralizing Gas
+    u16 holdEffect; // of the held item, before anything negating it
+    u8 flags;
+};
+
+EWRAM_DATA static struct BattlerEffectCache sBattlerEffectCache[MAX_BATTLERS_COUNT] = {0};
+EWRAM_DATA static u8 sBattlerEffectCacheDepth = 0;
+
+void BeginBattlerEffectCache(void)
+{
+    if (sBattlerEffectCacheDepth++ == 0)
+        InvalidateBattlerEffectCache();
+}
+
+void EndBattlerEffectCache(void)
+{
+    sBattlerEffectCacheDepth--;
+}
+
+void InvalidateBattlerEffectCache(void)
 {
+    u32 i;
+
+    for (i = 0; i < MAX_BATTLERS_COUNT; i++)
+        sBattlerEffectCache[i].flags = 0;
+}
+
+static u32 GetBattlerAbilityIgnoreMoldBreaker(u8 battlerId)
+{
+    struct BattlerEffectCache *cache = &sBattlerEffectCache[battlerId];
+    u32 ability;
+
+    if (sBattlerEffectCacheDepth != 0 && (cache->flags & BATTLER_CACHE_ABILITY))
+        return cache->ability;
+
     if (gStatuses3[battlerId] & STATUS3_GASTRO_ACID)
-        return ABILITY_NONE;
+        ability = ABILITY_NONE;
+    else if (IsNeutralizingGasOnField() && !IsNeutralizingGasBannedAbility(gBattleMons[battlerId].ability))
+        ability = ABILITY_NONE;
+    else
+        ability = gBattleMons[battlerId].ability;
 
-    if (IsNeutralizingGasOnField() && !IsNeutralizingGasBannedAbility(gBattleMons[battlerId].ability))
+    if (sBattlerEffectCacheDepth != 0)
+    {
+        cache->ability = ability;
+        cache->flags |= BATTLER_CACHE_ABILITY;
+    }
+
+    return ability;
+}
+
+u32 GetBattlerAbility(u8 battlerId)
+{
+    u32 ability = GetBattlerAbilityIgnoreMoldBreaker(battlerId);
+
+    if (ability == ABILITY_NONE)
         return ABILITY_NONE;
 
     if ((((gBattleMons[gBattlerAttacker].ability == ABILITY_MOLD_BREAKER
@@ -6082,13 +6146,13 @@ u32 GetBattlerAbility(u8 battlerId)
             || gBattleMons[gBattlerAttacker].ability == ABILITY_TURBOBLAZE)
             && !(gStatuses3[gBattlerAttacker] & STATUS3_GASTRO_ACID))
             || gBattleMoves[gCurrentMove].flags & FLAG_TARGET_ABILITY_IGNORED)
-            && sAbilitiesAffectedByMoldBreaker[gBattleMons[battlerId].ability]
+            && sAbilitiesAffectedByMoldBreaker[ability]
             && gBattlerByTurnOrder[gCurrentTurnActionNumber] == gBattlerAttacker
             && gActionsByTurnOrder[gBattlerByTurnOrder[gBattlerAttacker]] == B_ACTION_USE_MOVE
             && gCurrentTurnActionNumber < gBattlersCount)
         return ABILITY_NONE;
 
-    return gBattleMons[battlerId].ability;
+    return ability;
 }
 
 u32 IsAbilityOnSide(u32 battlerId, u32 ability)
@@ -7926,10 +7990,29 @@ u32 GetBattlerHoldEffect(u8 battlerId, bool32 checkNegating)
         return gBattleStruct->debugHoldEffects[battlerId];
     else
 #endif
+    return GetBattlerItemHoldEffect(battlerId);
+}
+
+static u32 GetBattlerItemHoldEffect(u8 battlerId)
+{
+    struct BattlerEffectCache *cache = &sBattlerEffectCache[battlerId];
+    u32 holdEffect;
+
+    if (sBattlerEffectCacheDepth != 0 && (cache->flags & BATTLER_CACHE_HOLD_EFFECT))
+        return cache->holdEffect;
+
     if (gBattleMons[battlerId].item == ITEM_ENIGMA_BERRY)
-        return gEnigmaBerries[battlerId].holdEffect;
+        holdEffect = gEnigmaBerries[battlerId].holdEffect;
     else
-        return ItemId_GetHoldEffect(gBattleMons[battlerId].item);
+        holdEffect = ItemId_GetHoldEffect(gBattleMons[battlerId].item);
+
+    if (sBattlerEffectCacheDepth != 0)
+    {
+        cache->holdEffect = holdEffect;
+        cache->flags |= BATTLER_CACHE_HOLD_EFFECT;
+    }
+
+    return holdEffect;
 }
 
 // 
@@ -9406,15 +9489,25 @@ static s32 DoMoveDamageCalc(u16 move, u8 battlerAtk, u8 battlerDef, u8 moveType,
 
 s32 CalculateMoveDamage(u16 move, u8 battlerAtk, u8 battlerDef, u8 moveType, s32 fixedBasePower, bool32 isCrit, bool32 randomFactor, bool32 updateFlags)
 {
-    return DoMoveDamageCalc(move, battlerAtk, battlerDef, moveType, fixedBasePower, isCrit, randomFactor,
-                            updateFlags, CalcTypeEffectivenessMultiplier(move, moveType, battlerAtk, battlerDef, updateFlags));
+    s32 dmg;
+
+    BeginBattlerEffectCache();
+    dmg = DoMoveDamageCalc(move, battlerAtk, battlerDef, moveType, fixedBasePower, isCrit, randomFactor,
+                           updateFlags, CalcTypeEffectivenessMultiplier(move, moveType, battlerAtk, battlerDef, updateFlags));
+    EndBattlerEffectCache();
+    return dmg;
 }
 
 // for AI - get move damage and effectiveness with one function call
 s32 CalculateMoveDamageAndEffectiveness(u16 move, u8 battlerAtk, u8 battlerDef, u8 moveType, u16 *typeEffectivenessModifier)
 {
+    s32 dmg;
+
+    BeginBattlerEffectCache();
     *typeEffectivenessModifier = CalcTypeEffectivenessMultiplier(move, moveType, battlerAtk, battlerDef, FALSE);
-    return DoMoveDamageCalc(move, battlerAtk, battlerDef, moveType, 0, FALSE, FALSE, FALSE, *typeEffectivenessModifier);
+    dmg = DoMoveDamageCalc(move, battlerAtk, battlerDef, moveType, 0, FALSE, FALSE, FALSE, *typeEffectivenessModifier);
+    EndBattlerEffectCache();
+    return dmg;
 }
 
 static void MulByTypeEffectiveness(u16 *modifier, u16 move, u8 moveType, u8 battlerDef, u8 defType, u8 battlerAtk, bool32 recordAbilities)
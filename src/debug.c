@@ -85,6 +85,10 @@ enum { // Util
     DEBUG_UTIL_MENU_ITEM_TRAINER_NAME,
     DEBUG_UTIL_MENU_ITEM_TRAINER_GENDER,
     DEBUG_UTIL_MENU_ITEM_TRAINER_ID,
+    DEBUG_UTIL_MENU_ITEM_HEAP_STATS,
+    DEBUG_UTIL_MENU_ITEM_TEXT_STATS,
+    DEBUG_UTIL_MENU_ITEM_TASK_STATS,
+    DEBUG_UTIL_MENU_ITEM_FRAME_PROFILE,
 };
 enum { // Scripts
     DEBUG_UTIL_MENU_ITEM_SCRIPT_1,
@@ -224,6 +228,10 @@ static void DebugAction_Util_WatchCredits(u8 taskId);
 static void DebugAction_Util_Trainer_Name(u8 taskId);
 static void DebugAction_Util_Trainer_Gender(u8 taskId);
 static void DebugAction_Util_Trainer_Id(u8 taskId);
+static void DebugAction_Util_HeapStats(u8 taskId);
+static void DebugAction_Util_TextStats(u8 taskId);
+static void DebugAction_Util_TaskStats(u8 taskId);
+static void DebugAction_Util_FrameProfile(u8 taskId);
 
 static void DebugAction_Flags_Flags(u8 taskId);
 static void DebugAction_Flags_FlagsSelect(u8 taskId);
@@ -329,6 +337,10 @@ static const u8 sDebugText_Util_WatchCredits[] =             _("Watch Credits");
 static const u8 sDebugText_Util_Trainer_Name[] =             _("Trainer name");
 static const u8 sDebugText_Util_Trainer_Gender[] =           _("Toggle T. Gender");
 static const u8 sDebugText_Util_Trainer_Id[] =               _("New Trainer Id");
+static const u8 sDebugText_Util_HeapStats[] =                _("Heap Stats");
+static const u8 sDebugText_Util_TextStats[] =                _("Text Width Cache");
+static const u8 sDebugText_Util_TaskStats[] =                _("Task Stats");
+static const u8 sDebugText_Util_FrameProfile[] =             _("Frame Profile");
 // Flags Menu
 static const u8 sDebugText_Flags_Flags[] =              _("Set Flag XXXX");
 static const u8 sDebugText_Flags_SetPokedexFlags[] =    _("All Pokédex Flags");
@@ -450,6 +462,10 @@ static const struct ListMenuItem sDebugMenu_Items_Utilities[] =
     [DEBUG_UTIL_MENU_ITEM_TRAINER_NAME]   = {sDebugText_Util_Trainer_Name,   DEBUG_UTIL_MENU_ITEM_TRAINER_NAME},
     [DEBUG_UTIL_MENU_ITEM_TRAINER_GENDER] = {sDebugText_Util_Trainer_Gender, DEBUG_UTIL_MENU_ITEM_TRAINER_GENDER},
     [DEBUG_UTIL_MENU_ITEM_TRAINER_ID]     = {sDebugText_Util_Trainer_Id,     DEBUG_UTIL_MENU_ITEM_TRAINER_ID},
+    [DEBUG_UTIL_MENU_ITEM_HEAP_STATS]     = {sDebugText_Util_HeapStats,      DEBUG_UTIL_MENU_ITEM_HEAP_STATS},
+    [DEBUG_UTIL_MENU_ITEM_TEXT_STATS]     = {sDebugText_Util_TextStats,      DEBUG_UTIL_MENU_ITEM_TEXT_STATS},
+    [DEBUG_UTIL_MENU_ITEM_TASK_STATS]     = {sDebugText_Util_TaskStats,      DEBUG_UTIL_MENU_ITEM_TASK_STATS},
+    [DEBUG_UTIL_MENU_ITEM_FRAME_PROFILE]  = {sDebugText_Util_FrameProfile,   DEBUG_UTIL_MENU_ITEM_FRAME_PROFILE},
 };
 static const struct ListMenuItem sDebugMenu_Items_Scripts[] =
 {
@@ -529,6 +545,10 @@ static void (*const sDebugMenu_Actions_Utilities[])(u8) =
     [DEBUG_UTIL_MENU_ITEM_TRAINER_NAME]   = DebugAction_Util_Trainer_Name,
     [DEBUG_UTIL_MENU_ITEM_TRAINER_GENDER] = DebugAction_Util_Trainer_Gender,
     [DEBUG_UTIL_MENU_ITEM_TRAINER_ID]     = DebugAction_Util_Trainer_Id,
+    [DEBUG_UTIL_MENU_ITEM_HEAP_STATS]     = DebugAction_Util_HeapStats,
+    [DEBUG_UTIL_MENU_ITEM_TEXT_STATS]     = DebugAction_Util_TextStats,
+    [DEBUG_UTIL_MENU_ITEM_TASK_STATS]     = DebugAction_Util_TaskStats,
+    [DEBUG_UTIL_MENU_ITEM_FRAME_PROFILE]  = DebugAction_Util_FrameProfile,
 };
 static void (*const sDebugMenu_Actions_Scripts[])(u8) =
 {
@@ -1173,6 +1193,134 @@ static void DebugAction_Util_CheckSaveBlock(u8 taskId)
     ScriptContext_SetupScript(Debug_ShowFieldMessageStringVar4);
 }
 
+static void DebugAction_Util_HeapStats(u8 taskId)
+{
+    static const u8 sDebugText_HeapUsage[] = _("Heap in use: {STR_VAR_1} bytes\nin {STR_VAR_3} blocks. Peak: {STR_VAR_2}.\p");
+    static const u8 sDebugText_HeapFree[] =  _("Free: {STR_VAR_1} bytes\nin {STR_VAR_3} blocks. Largest: {STR_VAR_2}.");
+    struct HeapStats stats;
+    const struct HeapCallsite *callsites;
+    u8 *end;
+    u32 i;
+
+    GetHeapStats(&stats);
+
+    ConvertIntToDecimalStringN(gStringVar1, stats.usedBytes, STR_CONV_MODE_LEFT_ALIGN, 6);
+    ConvertIntToDecimalStringN(gStringVar2, stats.peakUsedBytes, STR_CONV_MODE_LEFT_ALIGN, 6);
+    ConvertIntToDecimalStringN(gStringVar3, stats.usedBlocks, STR_CONV_MODE_LEFT_ALIGN, 5);
+    end = StringExpandPlaceholders(gStringVar4, sDebugText_HeapUsage);
+    ConvertIntToDecimalStringN(gStringVar1, stats.freeBytes, STR_CONV_MODE_LEFT_ALIGN, 6);
+    ConvertIntToDecimalStringN(gStringVar2, stats.largestFreeBlock, STR_CONV_MODE_LEFT_ALIGN, 6);
+    ConvertIntToDecimalStringN(gStringVar3, stats.freeBlocks, STR_CONV_MODE_LEFT_ALIGN, 5);
+    StringExpandPlaceholders(end, sDebugText_HeapFree);
+
+    // Per-callsite counts don't fit in a message box, so they go to the debug log.
+    callsites = GetHeapCallsites();
+    if (callsites != NULL)
+    {
+        for (i = 0; i < HEAP_CALLSITE_COUNT && callsites[i].callsite != NULL; i++)
+            DebugPrintf("Alloc from 0x%x: %d calls, %d bytes", (u32)callsites[i].callsite, callsites[i].allocCount, callsites[i].totalSize);
+    }
+
+    Debug_DestroyMenu_Full(taskId);
+    LockPlayerFieldControls();
+    ScriptContext_SetupScript(Debug_ShowFieldMessageStringVar4);
+}
+
+// Counts since the last time this was shown, so open a menu, use it, then
+// come back here to see how it did.
+static void DebugAction_Util_TextStats(u8 taskId)
+{
+    static const u8 sDebugText_TextStats[] = _("GetStringWidth: {STR_VAR_1} cached,\n{STR_VAR_2} measured, {STR_VAR_3} uncachable.");
+    struct StringWidthCacheStats stats;
+
+    GetStringWidthCacheStats(&stats);
+    ResetStringWidthCacheStats();
+
+    ConvertIntToDecimalStringN(gStringVar1, stats.hits, STR_CONV_MODE_LEFT_ALIGN, 7);
+    ConvertIntToDecimalStringN(gStringVar2, stats.misses, STR_CONV_MODE_LEFT_ALIGN, 7);
+    ConvertIntToDecimalStringN(gStringVar3, stats.uncached, STR_CONV_MODE_LEFT_ALIGN, 7);
+    StringExpandPlaceholders(gStringVar4, sDebugText_TextStats);
+
+    Debug_DestroyMenu_Full(taskId);
+    LockPlayerFieldControls();
+    ScriptContext_SetupScript(Debug_ShowFieldMessageStringVar4);
+}
+
+// Like the text stats, these count from the last time this was shown.
+static void DebugAction_Util_TaskStats(u8 taskId)
+{
+    static const u8 sDebugText_TaskCount[] =   _("Tasks in use: {STR_VAR_1} of {STR_VAR_2}.\nPeak: {STR_VAR_3}.");
+    static const u8 sDebugText_TaskFailed[] =  _(" Failed creates: {STR_VAR_1}.");
+    static const u8 sDebugText_TaskBusiest[] = _("\pBusiest: 0x{STR_VAR_1}\n{STR_VAR_2} cycles avg, {STR_VAR_3} peak.");
+    struct TaskStats stats;
+    const struct TaskProfile *profiles, *busiest = NULL;
+    u8 *end;
+    u32 i;
+
+    GetTaskStats(&stats);
+
+    ConvertIntToDecimalStringN(gStringVar1, stats.activeTasks, STR_CONV_MODE_LEFT_ALIGN, 3);
+    ConvertIntToDecimalStringN(gStringVar2, NUM_TASKS, STR_CONV_MODE_LEFT_ALIGN, 3);
+    ConvertIntToDecimalStringN(gStringVar3, stats.peakActiveTasks, STR_CONV_MODE_LEFT_ALIGN, 3);
+    end = StringExpandPlaceholders(gStringVar4, sDebugText_TaskCount);
+    ConvertIntToDecimalStringN(gStringVar1, stats.failedCreates, STR_CONV_MODE_LEFT_ALIGN, 5);
+    end = StringExpandPlaceholders(end, sDebugText_TaskFailed);
+
+    // Every task function only fits in the debug log.
+    profiles = GetTaskProfiles();
+    if (profiles != NULL)
+    {
+        for (i = 0; i < TASK_PROFILE_COUNT && profiles[i].func != NULL; i++)
+        {
+            DebugPrintf("Task 0x%x: %d calls, %d cycles, %d peak", (u32)profiles[i].func, profiles[i].calls, profiles[i].totalCycles, profiles[i].peakCycles);
+            if (busiest == NULL || profiles[i].totalCycles > busiest->totalCycles)
+                busiest = &profiles[i];
+        }
+    }
+
+    if (busiest != NULL)
+    {
+        ConvertIntToHexStringN(gStringVar1, (u32)busiest->func, STR_CONV_MODE_LEADING_ZEROS, 8);
+        ConvertIntToDecimalStringN(gStringVar2, busiest->totalCycles / busiest->calls, STR_CONV_MODE_LEFT_ALIGN, 7);
+        ConvertIntToDecimalStringN(gStringVar3, busiest->peakCycles, STR_CONV_MODE_LEFT_ALIGN, 7);
+        StringExpandPlaceholders(end, sDebugText_TaskBusiest);
+    }
+
+    ResetTaskStats();
+
+    Debug_DestroyMenu_Full(taskId);
+    LockPlayerFieldControls();
+    ScriptContext_SetupScript(Debug_ShowFieldMessageStringVar4);
+}
+
+// Opening the menu is a frame spike of its own, so it only shows the frames
+// before it. The per-frame stages go to the debug log.
+static void DebugAction_Util_FrameProfile(u8 taskId)
+{
+    static const u8 sDebugText_FrameProfile[] = _("Frames: {STR_VAR_1}% avg, {STR_VAR_2}% peak.\n{STR_VAR_3} over budget since boot.");
+    static const u8 sDebugText_FrameProfileOff[] = _("Set DEBUG_FRAME_PROFILING\nto profile frames.");
+    struct FrameProfileStats stats;
+
+    GetFrameProfileStats(&stats);
+    PrintFrameProfile();
+
+    if (stats.frames == 0)
+    {
+        StringCopy(gStringVar4, sDebugText_FrameProfileOff);
+    }
+    else
+    {
+        ConvertIntToDecimalStringN(gStringVar1, stats.averageCycles * 100 / CYCLES_PER_FRAME, STR_CONV_MODE_LEFT_ALIGN, 3);
+        ConvertIntToDecimalStringN(gStringVar2, stats.peakCycles * 100 / CYCLES_PER_FRAME, STR_CONV_MODE_LEFT_ALIGN, 3);
+        ConvertIntToDecimalStringN(gStringVar3, stats.overruns, STR_CONV_MODE_LEFT_ALIGN, 5);
+        StringExpandPlaceholders(gStringVar4, sDebugText_FrameProfile);
+    }
+
+    Debug_DestroyMenu_Full(taskId);
+    LockPlayerFieldControls();
+    ScriptContext_SetupScript(Debug_ShowFieldMessageStringVar4);
+}
+
 static const u8 sWeatherNames[22][24] = {
     [WEATHER_NONE]               = _("NONE"),
     [WEATHER_SUNNY_CLOUDS]       = _("SUNNY CLOUDS"),
@@ -6,6 +6,7 @@
 #include "fieldmap.h"
 #include "event_object_movement.h"
 #include "gpu_regs.h"
+#include "malloc.h"
 #include "menu.h"
 #include "overworld.h"
 #include "rotating_gate.h"
@@ -23,6 +24,29 @@ struct FieldCameraOffset
     bool8 copyBGToVRAM;
 };
 
+#define METATILE_DRAW_CACHE_SIZE 128
+#define METATILE_DRAW_CACHE_EMPTY 0xFFFF
+
+// What DrawMetatile writes to each background layer for one metatile, as
+// the top and bottom rows of two tiles each.
+struct MetatileDrawBlock
+{
+    u32 bg3[2];
+    u32 bg2[2];
+    u32 bg1[2];
+};
+
+// Draw blocks for the metatiles of the current tilesets, indexed by
+// metatile id modulo the size. Changing tilesets, like loading a map or
+// crossing into a connection with different ones, empties it.
+struct MetatileDrawCache
+{
+    const struct Tileset *primaryTileset;
+    const struct Tileset *secondaryTileset;
+    u16 metatileIds[METATILE_DRAW_CACHE_SIZE];
+    struct MetatileDrawBlock blocks[METATILE_DRAW_CACHE_SIZE];
+};
+
 static void RedrawMapSliceNorth(struct FieldCameraOffset *, const struct MapLayout *);
 static void RedrawMapSliceSouth(struct FieldCameraOffset *, const struct MapLayout *);
 static void RedrawMapSliceEast(struct FieldCameraOffset *, const struct MapLayout *);
@@ -31,6 +55,7 @@ static s32 MapPosToBgTilemapOffset(struct FieldCameraOffset *, s32, s32);
 static void DrawWholeMapViewInternal(int, int, const struct MapLayout *);
 static void DrawMetatileAt(const struct MapLayout *, u16, int, int);
 static void DrawMetatile(s32, const u16 *, u16);
+static void ScheduleMapTilemapCopies(void);
 static void CameraPanningCB_PanAhead(void);
 
 static struct FieldCameraOffset sFieldCameraOffset;
@@ -38,6 +63,7 @@ static s16 sHorizontalCameraPan;
 static s16 sVerticalCameraPan;
 static bool8 sBikeCameraPanFlag;
 static void (*sFieldCameraPanningCallback)(void);
+static struct MetatileDrawCache *sMetatileDrawCache;
 
 struct CameraObject gFieldCamera;
 u16 gTotalCameraPixelOffsetY;
@@ -118,6 +144,7 @@ static void DrawWholeMapViewInternal(int x, int y, const struct MapLayout *mapLa
             DrawMetatileAt(mapLayout, r6 + temp, x + j / 2, y + i / 2);
         }
     }
+    ScheduleMapTilemapCopies();
 }
 
 static void RedrawMapSlicesForCameraUpdate(struct FieldCameraOffset *cameraOffset, int x, int y)
@@ -132,6 +159,7 @@ static void RedrawMapSlicesForCameraUpdate(struct FieldCameraOffset *cameraOffse
         RedrawMapSliceNorth(cameraOffset, mapLayout);
     if (y < 0)
         RedrawMapSliceSouth(cameraOffset, mapLayout);
+    ScheduleMapTilemapCopies();
     cameraOffset->copyBGToVRAM = TRUE;
 }
 
@@ -208,6 +236,7 @@ void CurrentMapDrawMetatileAt(int x, int y)
     if (offset >= 0)
     {
         DrawMetatileAt(gMapHeader.mapLayout, offset, x, y);
+        ScheduleMapTilemapCopies();
         sFieldCameraOffset.copyBGToVRAM = TRUE;
     }
 }
@@ -223,21 +252,119 @@ void DrawDoorMetatileAt(int x, int y, u16 *tiles)
     }
 }
 
-static void DrawMetatileAt(const struct MapLayout *mapLayout, u16 offset, int x, int y)
+// Lives on the heap with the overworld tilemap buffers and, like them, is
+// allocated again every time they are, since warps reset the heap without
+// freeing anything. Without it the metatiles are drawn the slow way.
+void InitMetatileDrawCache(void)
 {
-    u16 metatileId = MapGridGetMetatileIdAt(x, y);
-    const u16 *metatiles;
+    sMetatileDrawCache = Alloc(sizeof(*sMetatileDrawCache));
+    if (sMetatileDrawCache != NULL)
+        sMetatileDrawCache->primaryTileset = NULL;
+}
 
+void FreeMetatileDrawCache(void)
+{
+    TRY_FREE_AND_SET_NULL(sMetatileDrawCache);
+}
+
+static const u16 *GetMetatileTiles(const struct MapLayout *mapLayout, u16 metatileId)
+{
     if (metatileId > NUM_METATILES_TOTAL)
         metatileId = 0;
     if (metatileId < NUM_METATILES_IN_PRIMARY)
-        metatiles = mapLayout->primaryTileset->metatiles;
+        return mapLayout->primaryTileset->metatiles + metatileId * NUM_TILES_PER_METATILE;
     else
+        return mapLayout->secondaryTileset->metatiles + (metatileId - NUM_METATILES_IN_PRIMARY) * NUM_TILES_PER_METATILE;
+}
+
+static void SetMetatileDrawLayer(u32 *rows, const u16 *tiles)
+{
+    rows[0] = tiles[0] | ((u32)tiles[1] << 16);
+    rows[1] = tiles[2] | ((u32)tiles[3] << 16);
+}
+
+static void FillMetatileDrawLayer(u32 *rows, u32 tile)
+{
+    rows[0] = rows[1] = tile | (tile << 16);
+}
+
+// Works out what DrawMetatile would write, see there for the layers.
+static bool32 BuildMetatileDrawBlock(struct MetatileDrawBlock *block, const u16 *tiles, u32 metatileLayerType)
+{
+    switch (metatileLayerType)
     {
-        metatiles = mapLayout->secondaryTileset->metatiles;
-        metatileId -= NUM_METATILES_IN_PRIMARY;
+    case METATILE_LAYER_TYPE_SPLIT:
+        SetMetatileDrawLayer(block->bg3, &tiles[0]);
+        FillMetatileDrawLayer(block->bg2, 0);
+        SetMetatileDrawLayer(block->bg1, &tiles[4]);
+        return TRUE;
+    case METATILE_LAYER_TYPE_COVERED:
+        SetMetatileDrawLayer(block->bg3, &tiles[0]);
+        SetMetatileDrawLayer(block->bg2, &tiles[4]);
+        FillMetatileDrawLayer(block->bg1, 0);
+        return TRUE;
+    case METATILE_LAYER_TYPE_NORMAL:
+        FillMetatileDrawLayer(block->bg3, 0x3014);
+        SetMetatileDrawLayer(block->bg2, &tiles[0]);
+        SetMetatileDrawLayer(block->bg1, &tiles[4]);
+        return TRUE;
     }
-    DrawMetatile(MapGridGetMetatileLayerTypeAt(x, y), metatiles + metatileId * NUM_TILES_PER_METATILE, offset);
+    return FALSE;
+}
+
+static const struct MetatileDrawBlock *GetMetatileDrawBlock(const struct MapLayout *mapLayout, u16 metatileId)
+{
+    struct MetatileDrawCache *cache = sMetatileDrawCache;
+    u32 index = metatileId % METATILE_DRAW_CACHE_SIZE;
+    u32 metatileLayerType;
+
+    if (cache == NULL)
+        return NULL;
+
+    if (cache->primaryTileset != mapLayout->primaryTileset || cache->secondaryTileset != mapLayout->secondaryTileset)
+    {
+        cache->primaryTileset = mapLayout->primaryTileset;
+        cache->secondaryTileset = mapLayout->secondaryTileset;
+        memset(cache->metatileIds, 0xFF, sizeof(cache->metatileIds));
+    }
+
+    if (cache->metatileIds[index] != metatileId)
+    {
+        metatileLayerType = (GetMetatileAttributesById(metatileId) & METATILE_ATTR_LAYER_MASK) >> METATILE_ATTR_LAYER_SHIFT;
+        if (!BuildMetatileDrawBlock(&cache->blocks[index], GetMetatileTiles(mapLayout, metatileId), metatileLayerType))
+        {
+            cache->metatileIds[index] = METATILE_DRAW_CACHE_EMPTY;
+            return NULL;
+        }
+        cache->metatileIds[index] = metatileId;
+    }
+    return &cache->blocks[index];
+}
+
+// The offset is always even, as the camera moves a metatile at a time, so
+// each row is one aligned word.
+static void DrawMetatileBlock(const struct MetatileDrawBlock *block, u16 offset)
+{
+    *(u32 *)&gOverworldTilemapBuffer_Bg3[offset] = block->bg3[0];
+    *(u32 *)&gOverworldTilemapBuffer_Bg3[offset + 0x20] = block->bg3[1];
+    *(u32 *)&gOverworldTilemapBuffer_Bg2[offset] = block->bg2[0];
+    *(u32 *)&gOverworldTilemapBuffer_Bg2[offset + 0x20] = block->bg2[1];
+    *(u32 *)&gOverworldTilemapBuffer_Bg1[offset] = block->bg1[0];
+    *(u32 *)&gOverworldTilemapBuffer_Bg1[offset + 0x20] = block->bg1[1];
+}
+
+static void DrawMetatileAt(const struct MapLayout *mapLayout, u16 offset, int x, int y)
+{
+    u16 metatileId = MapGridGetMetatileIdAt(x, y);
+    const struct MetatileDrawBlock *block = NULL;
+
+    if (!(offset & 1))
+        block = GetMetatileDrawBlock(mapLayout, metatileId);
+
+    if (block != NULL)
+        DrawMetatileBlock(block, offset);
+    else
+        DrawMetatile(MapGridGetMetatileLayerTypeAt(x, y), GetMetatileTiles(mapLayout, metatileId), offset);
 }
 
 static void DrawMetatile(s32 metatileLayerType, const u16 *tiles, u16 offset)
@@ -302,6 +429,11 @@ static void DrawMetatile(s32 metatileLayerType, const u16 *tiles, u16 offset)
         gOverworldTilemapBuffer_Bg1[offset + 0x21] = tiles[7];
         break;
     }
+    ScheduleMapTilemapCopies();
+}
+
+static void ScheduleMapTilemapCopies(void)
+{
     ScheduleBgCopyTilemapToVram(1);
     ScheduleBgCopyTilemapToVram(2);
     ScheduleBgCopyTilemapToVram(3);
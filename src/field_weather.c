@@ -547,10 +547,7 @@ static void ApplyColorMapWithBlend(u8 startPalIndex, u8 numPalettes, s8 colorMap
     u16 palOffset;
     u16 curPalIndex;
     u16 i;
-    struct RGBColor color = *(struct RGBColor *)&blendColor;
-    u8 rBlend = color.r;
-    u8 gBlend = color.g;
-    u8 bBlend = color.b;
+    const struct BlendLut *lut = GetBlendLut(blendCoeff, blendColor);
 
     palOffset = startPalIndex * 16;
     numPalettes += startPalIndex;
@@ -562,7 +559,7 @@ static void ApplyColorMapWithBlend(u8 startPalIndex, u8 numPalettes, s8 colorMap
         if (sPaletteColorMapTypes[curPalIndex] == COLOR_MAP_NONE)
         {
             // No color map. Simply blend the colors.
-            BlendPalette(palOffset, 16, blendCoeff, blendColor);
+            BlendPaletteWithLut(palOffset, 16, blendCoeff, blendColor);
             palOffset += 16;
         }
         else
@@ -577,15 +574,11 @@ static void ApplyColorMapWithBlend(u8 startPalIndex, u8 numPalettes, s8 colorMap
             for (i = 0; i < 16; i++)
             {
                 struct RGBColor baseColor = *(struct RGBColor *)&gPlttBufferUnfaded[palOffset];
-                u8 r = colorMap[baseColor.r];
-                u8 g = colorMap[baseColor.g];
-                u8 b = colorMap[baseColor.b];
 
                 // Apply color map and target blend color to the original color.
-                r += ((rBlend - r) * blendCoeff) >> 4;
-                g += ((gBlend - g) * blendCoeff) >> 4;
-                b += ((bBlend - b) * blendCoeff) >> 4;
-                gPlttBufferFaded[palOffset++] = RGB2(r, g, b);
+                gPlttBufferFaded[palOffset++] = lut->r[colorMap[baseColor.r]]
+                                              | lut->g[colorMap[baseColor.g]]
+                                              | lut->b[colorMap[baseColor.b]];
             }
         }
 
@@ -595,26 +588,19 @@ static void ApplyColorMapWithBlend(u8 startPalIndex, u8 numPalettes, s8 colorMap
 
 static void ApplyDroughtColorMapWithBlend(s8 colorMapIndex, u8 blendCoeff, u16 blendColor)
 {
-    struct RGBColor color;
-    u8 rBlend;
-    u8 gBlend;
-    u8 bBlend;
+    const struct BlendLut *lut = GetBlendLut(blendCoeff, blendColor);
     u16 curPalIndex;
     u16 palOffset;
     u16 i;
 
     colorMapIndex = -colorMapIndex - 1;
-    color = *(struct RGBColor *)&blendColor;
-    rBlend = color.r;
-    gBlend = color.g;
-    bBlend = color.b;
     palOffset = 0;
     for (curPalIndex = 0; curPalIndex < 32; curPalIndex++)
     {
         if (sPaletteColorMapTypes[curPalIndex] == COLOR_MAP_NONE)
         {
             // No color map. Simply blend the colors.
-            BlendPalette(palOffset, 16, blendCoeff, blendColor);
+            BlendPaletteWithLut(palOffset, 16, blendCoeff, blendColor);
             palOffset += 16;
         }
         else
@@ -625,7 +611,6 @@ static void ApplyDroughtColorMapWithBlend(s8 colorMapIndex, u8 blendCoeff, u16 b
                 struct RGBColor color1;
                 struct RGBColor color2;
                 u8 r1, g1, b1;
-                u8 r2, g2, b2;
 
                 color1 = *(struct RGBColor *)&gPlttBufferUnfaded[palOffset];
                 r1 = color1.r;
@@ -634,15 +619,8 @@ static void ApplyDroughtColorMapWithBlend(s8 colorMapIndex, u8 blendCoeff, u16 b
 
                 offset = ((b1 & 0x1E) << 7) | ((g1 & 0x1E) << 3) | ((r1 & 0x1E) >> 1);
                 color2 = *(struct RGBColor *)&sDroughtWeatherColors[colorMapIndex][offset];
-                r2 = color2.r;
-                g2 = color2.g;
-                b2 = color2.b;
 
-                r2 += ((rBlend - r2) * blendCoeff) >> 4;
-                g2 += ((gBlend - g2) * blendCoeff) >> 4;
-                b2 += ((bBlend - b2) * blendCoeff) >> 4;
-
-                gPlttBufferFaded[palOffset++] = RGB2(r2, g2, b2);
+                gPlttBufferFaded[palOffset++] = lut->r[color2.r] | lut->g[color2.g] | lut->b[color2.b];
             }
         }
     }
@@ -650,17 +628,11 @@ static void ApplyDroughtColorMapWithBlend(s8 colorMapIndex, u8 blendCoeff, u16 b
 
 static void ApplyFogBlend(u8 blendCoeff, u16 blendColor)
 {
-    struct RGBColor color;
-    u8 rBlend;
-    u8 gBlend;
-    u8 bBlend;
+    const struct BlendLut *lut;
     u16 curPalIndex;
 
-    BlendPalette(0, 256, blendCoeff, blendColor);
-    color = *(struct RGBColor *)&blendColor;
-    rBlend = color.r;
-    gBlend = color.g;
-    bBlend = color.b;
+    BlendPaletteWithLut(0, 256, blendCoeff, blendColor);
+    lut = GetBlendLut(blendCoeff, blendColor);
 
     for (curPalIndex = 16; curPalIndex < 32; curPalIndex++)
     {
@@ -680,17 +652,13 @@ static void ApplyFogBlend(u8 blendCoeff, u16 blendColor)
                 g += ((31 - g) * 3) >> 2;
                 b += ((28 - b) * 3) >> 2;
 
-                r += ((rBlend - r) * blendCoeff) >> 4;
-                g += ((gBlend - g) * blendCoeff) >> 4;
-                b += ((bBlend - b) * blendCoeff) >> 4;
-
-                gPlttBufferFaded[palOffset] = RGB2(r, g, b);
+                gPlttBufferFaded[palOffset] = lut->r[r] | lut->g[g] | lut->b[b];
                 palOffset++;
             }
         }
         else
         {
-            BlendPalette(curPalIndex * 16, 16, blendCoeff, blendColor);
+            BlendPaletteWithLut(curPalIndex * 16, 16, blendCoeff, blendColor);
         }
     }
 }
@@ -832,7 +800,7 @@ void UpdateSpritePaletteWithWeather(u8 spritePaletteIndex)
     case WEATHER_PAL_STATE_SCREEN_FADING_OUT:
         paletteIndex *= 16;
         CpuFastCopy(gPlttBufferFaded + paletteIndex, gPlttBufferUnfaded + paletteIndex, 32);
-        BlendPalette(paletteIndex, 16, gPaletteFade.y, gPaletteFade.blendColor);
+        BlendPaletteWithLut(paletteIndex, 16, gPaletteFade.y, gPaletteFade.blendColor);
         break;
     // WEATHER_PAL_STATE_CHANGING_WEATHER
     // WEATHER_PAL_STATE_CHANGING_IDLE
@@ -844,7 +812,7 @@ void UpdateSpritePaletteWithWeather(u8 spritePaletteIndex)
         else
         {
             paletteIndex *= 16;
-            BlendPalette(paletteIndex, 16, 12, RGB(28, 31, 28));
+            BlendPaletteWithLut(paletteIndex, 16, 12, RGB(28, 31, 28));
         }
         break;
     }
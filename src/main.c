@@ -71,6 +71,32 @@ s8 gPcmDmaCounter;
 
 static EWRAM_DATA u16 sTrainerId = 0;
 
+#if DEBUG_FRAME_PROFILING == TRUE
+#define FRAME_PROFILE_COUNT 32
+#define FRAME_SPIKE_COUNT 8
+
+struct FrameProfile
+{
+    u32 frame; // gMain.vblankCounter1 when the main loop started it
+    u32 busyCycles; // until the main loop waited for VBlank
+    u32 stageCycles[NUM_FRAME_STAGES];
+    u32 bgTilemapBytes;
+    u32 dma3Bytes;
+    u32 vblanks; // more than 1 means a frame was dropped
+};
+
+static u32 sFrameStart;
+static u32 sFrameStageStarts[NUM_FRAME_STAGES];
+static struct FrameProfile sCurrentFrameProfile;
+static EWRAM_DATA struct FrameProfile sFrameProfiles[FRAME_PROFILE_COUNT] = {0};
+static EWRAM_DATA struct FrameProfile sFrameSpikes[FRAME_SPIKE_COUNT] = {0};
+static EWRAM_DATA u32 sFrameProfileCount = 0;
+static EWRAM_DATA u16 sFrameOverrunCount = 0;
+
+static void StartFrameProfile(void);
+static void EndFrameProfile(void);
+#endif
+
 //EWRAM_DATA void (**gFlashTimerIntrFunc)(void) = NULL;
 
 static void UpdateLinkAndCallCallbacks(void);
@@ -128,6 +154,9 @@ void AgbMain()
 #endif
     for (;;)
     {
+#if DEBUG_FRAME_PROFILING == TRUE
+        StartFrameProfile();
+#endif
         ReadKeys();
 
         if (gSoftResetDisabled == FALSE
@@ -162,13 +191,22 @@ void AgbMain()
 
         PlayTimeCounter_Update();
         MapMusicMain();
+#if DEBUG_FRAME_PROFILING == TRUE
+        EndFrameProfile();
+#endif
         WaitForVBlank();
     }
 }
 
 static void UpdateLinkAndCallCallbacks(void)
 {
-    if (!HandleLinkConnection())
+    bool32 linkBusy;
+
+    FRAME_STAGE_START(FRAME_STAGE_LINK);
+    linkBusy = HandleLinkConnection();
+    FRAME_STAGE_END(FRAME_STAGE_LINK);
+
+    if (!linkBusy)
         CallCallbacks();
 }
 
@@ -186,10 +224,18 @@ static void InitMainCallbacks(void)
 static void CallCallbacks(void)
 {
     if (gMain.callback1)
+    {
+        FRAME_STAGE_START(FRAME_STAGE_CALLBACK1);
         gMain.callback1();
+        FRAME_STAGE_END(FRAME_STAGE_CALLBACK1);
+    }
 
     if (gMain.callback2)
+    {
+        FRAME_STAGE_START(FRAME_STAGE_CALLBACK2);
         gMain.callback2();
+        FRAME_STAGE_END(FRAME_STAGE_CALLBACK2);
+    }
 }
 
 void SetMainCallback2(MainCallback callback)
@@ -216,6 +262,155 @@ u16 GetGeneratedTrainerIdLower(void)
     return sTrainerId;
 }
 
+// Timers 1 and 2 cascaded into a free-running count of CPU cycles, for
+// profiling. The naming screen stops timer 1 after seeding the RNG with it and
+// flash writes take over timer 2, so check IsCycleCounterRunning after
+// anything that might have done either.
+void StartCycleCounter(void)
+{
+    if (IsCycleCounterRunning())
+        return;
+
+    REG_TM1CNT_H = 0;
+    REG_TM2CNT_H = 0;
+    REG_TM1CNT_L = 0;
+    REG_TM2CNT_L = 0;
+    REG_TM2CNT_H = TIMER_ENABLE | TIMER_COUNTUP;
+    REG_TM1CNT_H = TIMER_ENABLE | TIMER_1CLK;
+}
+
+bool32 IsCycleCounterRunning(void)
+{
+    return REG_TM1CNT_H == (TIMER_ENABLE | TIMER_1CLK)
+        && REG_TM2CNT_H == (TIMER_ENABLE | TIMER_COUNTUP);
+}
+
+u32 GetCycleCount(void)
+{
+    u16 high, low;
+
+    // Read the high half again in case the low half wrapped in between.
+    do
+    {
+        high = REG_TM2CNT_L;
+        low = REG_TM1CNT_L;
+    } while (high != REG_TM2CNT_L);
+
+    return (high << 16) | low;
+}
+
+#if DEBUG_FRAME_PROFILING == TRUE
+void StartFrameStage(u32 stage)
+{
+    sFrameStageStarts[stage] = GetCycleCount();
+}
+
+void EndFrameStage(u32 stage)
+{
+    sCurrentFrameProfile.stageCycles[stage] += GetCycleCount() - sFrameStageStarts[stage];
+}
+
+// Files away the frame that just finished, along with the VBlank after it,
+// and starts timing the next one.
+static void StartFrameProfile(void)
+{
+    struct FrameProfile *frame = &sCurrentFrameProfile;
+    struct BgTilemapCopyStats bgThisFrame, bgLastFrame;
+    struct Dma3Stats dma3Stats;
+
+    // The counter stops for saves, which leaves nothing to go on.
+    if (frame->frame != 0 && IsCycleCounterRunning())
+    {
+        frame->vblanks = gMain.vblankCounter1 - frame->frame;
+        GetBgTilemapCopyStats(&bgThisFrame, &bgLastFrame);
+        if (bgLastFrame.frame == frame->frame)
+            frame->bgTilemapBytes = bgLastFrame.bytesCopied;
+        GetDma3Stats(&dma3Stats);
+        frame->dma3Bytes = dma3Stats.bytesTransferred;
+
+        sFrameProfiles[sFrameProfileCount++ % FRAME_PROFILE_COUNT] = *frame;
+        if (frame->busyCycles > CYCLES_PER_FRAME || frame->vblanks > 1)
+            sFrameSpikes[sFrameOverrunCount++ % FRAME_SPIKE_COUNT] = *frame;
+    }
+
+    StartCycleCounter();
+    memset(frame, 0, sizeof(*frame));
+    frame->frame = gMain.vblankCounter1;
+    sFrameStart = GetCycleCount();
+}
+
+static void EndFrameProfile(void)
+{
+    sCurrentFrameProfile.busyCycles = GetCycleCount() - sFrameStart;
+}
+
+static void PrintFrame(const struct FrameProfile *frame)
+{
+    DebugPrintf("%u: %u (%u%%) %u %u %u %u %u %u | %u %u %u %u %u %u | %u %u %u",
+                frame->frame, frame->busyCycles, frame->busyCycles * 100 / CYCLES_PER_FRAME,
+                frame->stageCycles[FRAME_STAGE_LINK], frame->stageCycles[FRAME_STAGE_CALLBACK1],
+                frame->stageCycles[FRAME_STAGE_CALLBACK2], frame->stageCycles[FRAME_STAGE_TASKS],
+                frame->stageCycles[FRAME_STAGE_ANIMATE_SPRITES], frame->stageCycles[FRAME_STAGE_BUILD_OAM],
+                frame->stageCycles[FRAME_STAGE_VBLANK], frame->stageCycles[FRAME_STAGE_VBLANK_CALLBACK],
+                frame->stageCycles[FRAME_STAGE_LOAD_OAM], frame->stageCycles[FRAME_STAGE_TRANSFER_PLTT],
+                frame->stageCycles[FRAME_STAGE_DMA3], frame->stageCycles[FRAME_STAGE_SOUND],
+                frame->vblanks, frame->bgTilemapBytes, frame->dma3Bytes);
+}
+#endif
+
+void GetFrameProfileStats(struct FrameProfileStats *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+#if DEBUG_FRAME_PROFILING == TRUE
+    {
+        u32 i, total = 0;
+
+        stats->frames = min(sFrameProfileCount, FRAME_PROFILE_COUNT);
+        stats->overruns = sFrameOverrunCount;
+        for (i = 0; i < stats->frames; i++)
+        {
+            total += sFrameProfiles[i].busyCycles;
+            if (sFrameProfiles[i].busyCycles > stats->peakCycles)
+                stats->peakCycles = sFrameProfiles[i].busyCycles;
+        }
+        if (stats->frames != 0)
+            stats->averageCycles = total / stats->frames;
+    }
+#endif
+}
+
+// Sends the recent frames and the last ones that went over budget to the
+// debug log, oldest first. Times are in cycles.
+void PrintFrameProfile(void)
+{
+#if DEBUG_FRAME_PROFILING == TRUE
+    u32 i, count;
+    struct Dma3Stats dma3Stats;
+    struct StringWidthCacheStats textStats;
+
+    DebugPrintf("frame: busy (of frame) link cb1 cb2 tasks anim buildoam | vblank vblankcb loadoam pltt dma3 sound | vblanks bgbytes dma3bytes");
+
+    count = min(sFrameProfileCount, FRAME_PROFILE_COUNT);
+    DebugPrintf("Last %u frames:", count);
+    for (i = sFrameProfileCount - count; i < sFrameProfileCount; i++)
+        PrintFrame(&sFrameProfiles[i % FRAME_PROFILE_COUNT]);
+
+    count = min(sFrameOverrunCount, FRAME_SPIKE_COUNT);
+    DebugPrintf("Last %u of %u frames over budget:", count, sFrameOverrunCount);
+    for (i = sFrameOverrunCount - count; i < sFrameOverrunCount; i++)
+        PrintFrame(&sFrameSpikes[i % FRAME_SPIKE_COUNT]);
+
+    GetDma3Stats(&dma3Stats);
+    DebugPrintf("DMA3: %u requests queued, %u merged, %u bytes deferred, worst overrun %u lines",
+                dma3Stats.requestsQueued, dma3Stats.requestsCoalesced, dma3Stats.bytesDeferred, dma3Stats.worstOverrunLines);
+    GetStringWidthCacheStats(&textStats);
+    DebugPrintf("GetStringWidth: %u cached, %u measured, %u uncachable",
+                textStats.hits, textStats.misses, textStats.uncached);
+#else
+    DebugPrintf("Frame profiling is off, set DEBUG_FRAME_PROFILING to TRUE");
+#endif
+}
+
 void EnableVCountIntrAtLine150(void)
 {
     u16 gpuReg = (GetGpuReg(REG_OFFSET_DISPSTAT) & 0xFF) | (150 << 8);
@@ -337,6 +532,8 @@ void SetSerialCallback(IntrCallback callback)
 
 static void VBlankIntr(void)
 {
+    FRAME_STAGE_START(FRAME_STAGE_VBLANK);
+
     if (gWirelessCommType != 0)
         RfuVSync();
     else if (gLinkVSyncDisabled == FALSE)
@@ -348,16 +545,24 @@ static void VBlankIntr(void)
         (*gTrainerHillVBlankCounter)++;
 
     if (gMain.vblankCallback)
+    {
+        FRAME_STAGE_START(FRAME_STAGE_VBLANK_CALLBACK);
         gMain.vblankCallback();
+        FRAME_STAGE_END(FRAME_STAGE_VBLANK_CALLBACK);
+    }
 
     gMain.vblankCounter2++;
 
     CopyBufferedValuesToGpuRegs();
+    FRAME_STAGE_START(FRAME_STAGE_DMA3);
     ProcessDma3Requests();
+    FRAME_STAGE_END(FRAME_STAGE_DMA3);
 
     gPcmDmaCounter = gSoundInfo.pcmDmaCounter;
 
+    FRAME_STAGE_START(FRAME_STAGE_SOUND);
     m4aSoundMain();
+    FRAME_STAGE_END(FRAME_STAGE_SOUND);
     TryReceiveLinkBattleData();
 
     if (!gMain.inBattle || !(gBattleTypeFlags & (BATTLE_TYPE_LINK | BATTLE_TYPE_FRONTIER | BATTLE_TYPE_RECORDED)))
@@ -365,6 +570,8 @@ static void VBlankIntr(void)
 
     UpdateWirelessStatusIndicatorSprite();
 
+    FRAME_STAGE_END(FRAME_STAGE_VBLANK);
+
     INTR_CHECK |= INTR_FLAG_VBLANK;
     gMain.intrCheck |= INTR_FLAG_VBLANK;
 }
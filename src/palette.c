@@ -3,6 +3,7 @@
 #include "util.h"
 #include "decompress.h"
 #include "gpu_regs.h"
+#include "main.h"
 #include "task.h"
 #include "constants/rgb.h"
 
@@ -102,6 +103,7 @@ void FillPalette(u16 value, u16 offset, u16 size)
 
 void TransferPlttBuffer(void)
 {
+    FRAME_STAGE_START(FRAME_STAGE_TRANSFER_PLTT);
     if (!gPaletteFade.bufferTransferDisabled)
     {
         void *src = gPlttBufferFaded;
@@ -111,6 +113,7 @@ void TransferPlttBuffer(void)
         if (gPaletteFade.mode == HARDWARE_FADE && gPaletteFade.active)
             UpdateBlendRegisters();
     }
+    FRAME_STAGE_END(FRAME_STAGE_TRANSFER_PLTT);
 }
 
 u8 UpdatePaletteFade(void)
@@ -291,7 +294,7 @@ static void PaletteStruct_Blend(struct PaletteStruct *palStruct, u32 *unkFlags)
         {
             if (gPaletteFade.delayCounter != gPaletteFade_delay)
             {
-                BlendPalette(
+                BlendPaletteWithLut(
                     palStruct->baseDestOffset,
                     palStruct->template->size,
                     gPaletteFade.y,
@@ -446,7 +449,7 @@ static u8 UpdateNormalPaletteFade(void)
         while (selectedPalettes)
         {
             if (selectedPalettes & 1)
-                BlendPalette(
+                BlendPaletteWithLut(
                     paletteOffset,
                     16,
                     gPaletteFade.y,
@@ -838,7 +841,7 @@ void BlendPalettes(u32 selectedPalettes, u8 coeff, u16 color)
     for (paletteOffset = 0; selectedPalettes; paletteOffset += 16)
     {
         if (selectedPalettes & 1)
-            BlendPalette(paletteOffset, 16, coeff, color);
+            BlendPaletteWithLut(paletteOffset, 16, coeff, color);
         selectedPalettes >>= 1;
     }
 }
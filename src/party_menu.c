@@ -864,22 +864,46 @@ static void RenderPartyMenuBox(u8 slot)
     }
 }
 
+// Same as calling each of the DisplayPartyPokemon*Check functions, but the
+// encrypted data they need is only decrypted once.
 static void DisplayPartyPokemonData(u8 slot)
 {
-    if (GetMonData(&gPlayerParty[slot], MON_DATA_IS_EGG))
+    struct Pokemon *mon = &gPlayerParty[slot];
+    struct PartyMenuBox *menuBox = &sPartyMenuBoxes[slot];
+    struct BoxMonAccess access;
+    u8 nickname[POKEMON_NAME_LENGTH + 1];
+    u16 species, hp, maxHP;
+    u8 ailment, gender;
+
+    BeginBoxMonAccess(&access, &mon->box);
+    species = GetBoxMonAccessData(&access, MON_DATA_SPECIES, NULL);
+    GetBoxMonAccessData(&access, MON_DATA_NICKNAME, nickname);
+    StringGet_Nickname(nickname);
+
+    if (GetBoxMonAccessData(&access, MON_DATA_IS_EGG, NULL))
     {
-        sPartyMenuBoxes[slot].infoRects->blitFunc(sPartyMenuBoxes[slot].windowId, 0, 0, 0, 0, TRUE);
-        DisplayPartyPokemonNickname(&gPlayerParty[slot], &sPartyMenuBoxes[slot], 0);
+        menuBox->infoRects->blitFunc(menuBox->windowId, 0, 0, 0, 0, TRUE);
+        if (species != SPECIES_NONE)
+            DisplayPartyPokemonBarDetail(menuBox->windowId, nickname, 0, menuBox->infoRects->dimensions);
     }
     else
     {
-        sPartyMenuBoxes[slot].infoRects->blitFunc(sPartyMenuBoxes[slot].windowId, 0, 0, 0, 0, FALSE);
-        DisplayPartyPokemonNickname(&gPlayerParty[slot], &sPartyMenuBoxes[slot], 0);
-        DisplayPartyPokemonLevelCheck(&gPlayerParty[slot], &sPartyMenuBoxes[slot], 0);
-        DisplayPartyPokemonGenderNidoranCheck(&gPlayerParty[slot], &sPartyMenuBoxes[slot], 0);
-        DisplayPartyPokemonHPCheck(&gPlayerParty[slot], &sPartyMenuBoxes[slot], 0);
-        DisplayPartyPokemonMaxHPCheck(&gPlayerParty[slot], &sPartyMenuBoxes[slot], 0);
-        DisplayPartyPokemonHPBarCheck(&gPlayerParty[slot], &sPartyMenuBoxes[slot]);
+        menuBox->infoRects->blitFunc(menuBox->windowId, 0, 0, 0, 0, FALSE);
+        if (species != SPECIES_NONE)
+        {
+            hp = GetMonData(mon, MON_DATA_HP);
+            maxHP = GetMonData(mon, MON_DATA_MAX_HP);
+            ailment = GetMonAilment(mon);
+            gender = GetGenderFromSpeciesAndPersonality(species, GetBoxMonAccessData(&access, MON_DATA_PERSONALITY, NULL));
+
+            DisplayPartyPokemonBarDetail(menuBox->windowId, nickname, 0, menuBox->infoRects->dimensions);
+            if (ailment == AILMENT_NONE || ailment == AILMENT_PKRS)
+                DisplayPartyPokemonLevel(GetMonData(mon, MON_DATA_LEVEL), menuBox);
+            DisplayPartyPokemonGender(gender, species, nickname, menuBox);
+            DisplayPartyPokemonHP(hp, maxHP, menuBox);
+            DisplayPartyPokemonMaxHP(maxHP, menuBox);
+            DisplayPartyPokemonHPBar(hp, maxHP, menuBox);
+        }
     }
 }
 
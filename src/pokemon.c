@@ -3421,6 +3421,135 @@ void CreateMon(struct Pokemon *mon, u16 species, u8 level, u8 fixedIV, u8 hasFix
     CalculateMonStats(mon);
 }
 
+// The letter of an Unown is read from the low two bits of each byte of its
+// personality, as an 8-bit number modulo NUM_UNOWN_FORMS.
+#define UNOWN_LETTER_PERSONALITY_MASK 0x03030303
+
+// The top bits of a personality are free to pick the nature with. 1 << 26 is
+// 14 modulo NUM_NATURES and 9 is its inverse, so every nature can be reached.
+#define NATURE_PERSONALITY_SHIFT 26
+#define NATURE_PERSONALITY_INVERSE 9
+
+static u32 GetUnownLetterPersonalityBits(u8 letter)
+{
+    // 256 isn't a multiple of NUM_UNOWN_FORMS, so the first few letters have
+    // one more value that maps to them.
+    u32 count = (letter < 256 % NUM_UNOWN_FORMS) ? (256 / NUM_UNOWN_FORMS + 1) : (256 / NUM_UNOWN_FORMS);
+    u32 value = letter + NUM_UNOWN_FORMS * RandomBelow(count);
+
+    return ((value & 0xC0) << 18) | ((value & 0x30) << 12) | ((value & 0x0C) << 6) | (value & 0x03);
+}
+
+// Builds a personality with the given nature, gender and Unown letter (0 for
+// none) directly, instead of drawing Random32() until one matches. The result
+// is uniformly distributed over the matching personalities, just as it was
+// with rejection sampling. A gender the species can't have is ignored, so pass
+// MON_GENDERLESS for any gender, and NUM_NATURES for any nature.
+static u32 GeneratePersonality(u16 species, u8 gender, u8 nature, u8 unownLetter)
+{
+    u8 genderRatio = gSpeciesInfo[species].genderRatio;
+    bool32 anyGender = (gender == MON_GENDERLESS);
+    u32 personality, natureBits;
+
+    switch (genderRatio)
+    {
+    case MON_MALE:
+    case MON_FEMALE:
+    case MON_GENDERLESS:
+        anyGender = TRUE;
+        break;
+    }
+
+    while (TRUE)
+    {
+        personality = Random32();
+
+        if (unownLetter != 0)
+        {
+            // The letter shares the low byte with the gender, so the gender is
+            // checked rather than set.
+            personality &= ~UNOWN_LETTER_PERSONALITY_MASK;
+            personality |= GetUnownLetterPersonalityBits(unownLetter - 1);
+            if (!anyGender && gender != GetGenderFromSpeciesAndPersonality(species, personality))
+                continue;
+        }
+        else if (!anyGender)
+        {
+            // Females have a low byte below the gender ratio, males one at or above it.
+            personality &= ~0xFF;
+            if (gender == MON_FEMALE)
+                personality |= RandomBelow(genderRatio);
+            else
+                personality |= genderRatio + RandomBelow(256 - genderRatio);
+        }
+
+        if (nature >= NUM_NATURES)
+            return personality;
+
+        // Solve for the top bits that give the nature. Each nature has two or
+        // three solutions, so pick one of three and start over if it's out of
+        // range, which keeps every personality equally likely.
+        personality &= (1 << NATURE_PERSONALITY_SHIFT) - 1;
+        natureBits = (nature + NUM_NATURES - personality % NUM_NATURES) * NATURE_PERSONALITY_INVERSE % NUM_NATURES;
+        natureBits += NUM_NATURES * RandomBelow(3);
+        if (natureBits < (1 << (32 - NATURE_PERSONALITY_SHIFT)))
+            return personality | (natureBits << NATURE_PERSONALITY_SHIFT);
+    }
+}
+
+static u32 GetPlayerOtId(void)
+{
+    return gSaveBlock2Ptr->playerTrainerId[0]
+         | (gSaveBlock2Ptr->playerTrainerId[1] << 8)
+         | (gSaveBlock2Ptr->playerTrainerId[2] << 16)
+         | (gSaveBlock2Ptr->playerTrainerId[3] << 24);
+}
+
+// Rerolls the personality of a mon caught or received by the player for the
+// shiny odds. Rerolls keep the nature, gender and Unown letter asked for.
+static u32 RollShinyPersonality(u32 otId, u32 personality, u16 species, u8 gender, u8 nature, u8 unownLetter)
+{
+#if P_FLAG_FORCE_NO_SHINY != 0
+    if (FlagGet(P_FLAG_FORCE_NO_SHINY))
+    {
+        while (GET_SHINY_VALUE(otId, personality) < SHINY_ODDS)
+            personality = GeneratePersonality(species, gender, nature, unownLetter);
+    }
+#endif
+#if P_FLAG_FORCE_SHINY != 0
+  #if P_FLAG_FORCE_NO_SHINY != 0
+    else
+  #endif
+    if (FlagGet(P_FLAG_FORCE_SHINY))
+    {
+        while (GET_SHINY_VALUE(otId, personality) >= SHINY_ODDS)
+            personality = GeneratePersonality(species, gender, nature, unownLetter);
+    }
+#endif
+#if P_FLAG_FORCE_SHINY != 0 || P_FLAG_FORCE_NO_SHINY != 0
+    else
+#endif
+    {
+    #if P_SHINY_BASE_CHANCE >= GEN_6
+        u32 totalRerolls = 1;
+    #else
+        u32 totalRerolls = 0;
+    #endif
+        if (CheckBagHasItem(ITEM_SHINY_CHARM, 1))
+            totalRerolls += I_SHINY_CHARM_REROLLS;
+        if (LURE_STEP_COUNT != 0)
+            totalRerolls += 1;
+
+        while (GET_SHINY_VALUE(otId, personality) >= SHINY_ODDS && totalRerolls > 0)
+        {
+            personality = GeneratePersonality(species, gender, nature, unownLetter);
+            totalRerolls--;
+        }
+    }
+
+    return personality;
+}
+
 void CreateBoxMon(struct BoxPokemon *boxMon, u16 species, u8 level, u8 fixedIV, u8 hasFixedPersonality, u32 fixedPersonality, u8 otIdType, u32 fixedOtId)
 {
     u8 speciesName[POKEMON_NAME_LENGTH + 1];
@@ -3455,48 +3584,8 @@ void CreateBoxMon(struct BoxPokemon *boxMon, u16 species, u8 level, u8 fixedIV,
     }
     else // Player is the OT
     {
-        value = gSaveBlock2Ptr->playerTrainerId[0]
-              | (gSaveBlock2Ptr->playerTrainerId[1] << 8)
-              | (gSaveBlock2Ptr->playerTrainerId[2] << 16)
-              | (gSaveBlock2Ptr->playerTrainerId[3] << 24);
-
-#if P_FLAG_FORCE_NO_SHINY != 0
-        if (FlagGet(P_FLAG_FORCE_NO_SHINY))
-        {
-            while (GET_SHINY_VALUE(value, personality) < SHINY_ODDS)
-                personality = Random32();
-        }
-#endif
-#if P_FLAG_FORCE_SHINY != 0
-    #if P_FLAG_FORCE_NO_SHINY != 0
-        else
-    #endif
-        if (FlagGet(P_FLAG_FORCE_SHINY))
-        {
-            while (GET_SHINY_VALUE(value, personality) >= SHINY_ODDS)
-                personality = Random32();
-        }
-#endif
-#if P_FLAG_FORCE_SHINY != 0 || P_FLAG_FORCE_NO_SHINY != 0
-        else
-#endif
-        {
-        #if P_SHINY_BASE_CHANCE >= GEN_6
-            u32 totalRerolls = 1;
-        #else
-            u32 totalRerolls = 0;
-        #endif
-            if (CheckBagHasItem(ITEM_SHINY_CHARM, 1))
-                totalRerolls += I_SHINY_CHARM_REROLLS;
-            if (LURE_STEP_COUNT != 0)
-                totalRerolls += 1;
-
-            while (GET_SHINY_VALUE(value, personality) >= SHINY_ODDS && totalRerolls > 0)
-            {
-                personality = Random32();
-                totalRerolls--;
-            }
-        }
+        value = GetPlayerOtId();
+        personality = RollShinyPersonality(value, personality, species, MON_GENDERLESS, NUM_NATURES, 0);
     }
 
     SetBoxMonData(boxMon, MON_DATA_PERSONALITY, &personality);
@@ -3614,47 +3703,29 @@ void CreateBoxMon(struct BoxPokemon *boxMon, u16 species, u8 level, u8 fixedIV,
     GiveBoxMonInitialMoveset(boxMon);
 }
 
-void CreateMonWithNature(struct Pokemon *mon, u16 species, u8 level, u8 fixedIV, u8 nature)
+// CreateBoxMon would reroll a fixed personality for the shiny odds without
+// regard for its nature, so the rerolls are done here and the player's ID is
+// passed as a preset.
+static void CreatePlayerMonWithPersonality(struct Pokemon *mon, u16 species, u8 level, u8 fixedIV, u8 gender, u8 nature, u8 unownLetter)
 {
-    u32 personality;
+    u32 otId = GetPlayerOtId();
+    u32 personality = GeneratePersonality(species, gender, nature, unownLetter);
 
-    do
-    {
-        personality = Random32();
-    }
-    while (nature != GetNatureFromPersonality(personality));
+    personality = RollShinyPersonality(otId, personality, species, gender, nature, unownLetter);
+    CreateMon(mon, species, level, fixedIV, TRUE, personality, OT_ID_PRESET, otId);
+}
 
-    CreateMon(mon, species, level, fixedIV, TRUE, personality, OT_ID_PLAYER_ID, 0);
+void CreateMonWithNature(struct Pokemon *mon, u16 species, u8 level, u8 fixedIV, u8 nature)
+{
+    CreatePlayerMonWithPersonality(mon, species, level, fixedIV, MON_GENDERLESS, nature, 0);
 }
 
 void CreateMonWithGenderNatureLetter(struct Pokemon *mon, u16 species, u8 level, u8 fixedIV, u8 gender, u8 nature, u8 unownLetter)
 {
-    u32 personality;
-
     if ((u8)(unownLetter - 1) < NUM_UNOWN_FORMS)
-    {
-        u16 actualLetter;
-
-        do
-        {
-            personality = Random32();
-            actualLetter = GET_UNOWN_LETTER(personality);
-        }
-        while (nature != GetNatureFromPersonality(personality)
-            || gender != GetGenderFromSpeciesAndPersonality(species, personality)
-            || actualLetter != unownLetter - 1);
-    }
+        CreatePlayerMonWithPersonality(mon, species, level, fixedIV, gender, nature, unownLetter);
     else
-    {
-        do
-        {
-            personality = Random32();
-        }
-        while (nature != GetNatureFromPersonality(personality)
-            || gender != GetGenderFromSpeciesAndPersonality(species, personality));
-    }
-
-    CreateMon(mon, species, level, fixedIV, TRUE, personality, OT_ID_PLAYER_ID, 0);
+        CreatePlayerMonWithPersonality(mon, species, level, fixedIV, gender, nature, 0);
 }
 
 // This is only used to create Wally's Ralts.
@@ -4089,23 +4160,30 @@ static u16 CalculateBoxMonChecksum(struct BoxPokemon *boxMon)
 
 void CalculateMonStats(struct Pokemon *mon)
 {
-    s32 oldMaxHP = GetMonData(mon, MON_DATA_MAX_HP, NULL);
-    s32 currentHP = GetMonData(mon, MON_DATA_HP, NULL);
-    s32 hpIV = GetMonData(mon, MON_DATA_HP_IV, NULL);
-    s32 hpEV = GetMonData(mon, MON_DATA_HP_EV, NULL);
-    s32 attackIV = GetMonData(mon, MON_DATA_ATK_IV, NULL);
-    s32 attackEV = GetMonData(mon, MON_DATA_ATK_EV, NULL);
-    s32 defenseIV = GetMonData(mon, MON_DATA_DEF_IV, NULL);
-    s32 defenseEV = GetMonData(mon, MON_DATA_DEF_EV, NULL);
-    s32 speedIV = GetMonData(mon, MON_DATA_SPEED_IV, NULL);
-    s32 speedEV = GetMonData(mon, MON_DATA_SPEED_EV, NULL);
-    s32 spAttackIV = GetMonData(mon, MON_DATA_SPATK_IV, NULL);
-    s32 spAttackEV = GetMonData(mon, MON_DATA_SPATK_EV, NULL);
-    s32 spDefenseIV = GetMonData(mon, MON_DATA_SPDEF_IV, NULL);
-    s32 spDefenseEV = GetMonData(mon, MON_DATA_SPDEF_EV, NULL);
-    u16 species = GetMonData(mon, MON_DATA_SPECIES, NULL);
-    s32 level = GetLevelFromMonExp(mon);
-    s32 newMaxHP;
+    struct BoxMonAccess access;
+    s32 oldMaxHP, currentHP, newMaxHP, level;
+    s32 hpIV, hpEV, attackIV, attackEV, defenseIV, defenseEV;
+    s32 speedIV, speedEV, spAttackIV, spAttackEV, spDefenseIV, spDefenseEV;
+    u16 species;
+
+    oldMaxHP = GetMonData(mon, MON_DATA_MAX_HP, NULL);
+    currentHP = GetMonData(mon, MON_DATA_HP, NULL);
+
+    BeginBoxMonAccess(&access, &mon->box);
+    hpIV = GetBoxMonAccessData(&access, MON_DATA_HP_IV, NULL);
+    hpEV = GetBoxMonAccessData(&access, MON_DATA_HP_EV, NULL);
+    attackIV = GetBoxMonAccessData(&access, MON_DATA_ATK_IV, NULL);
+    attackEV = GetBoxMonAccessData(&access, MON_DATA_ATK_EV, NULL);
+    defenseIV = GetBoxMonAccessData(&access, MON_DATA_DEF_IV, NULL);
+    defenseEV = GetBoxMonAccessData(&access, MON_DATA_DEF_EV, NULL);
+    speedIV = GetBoxMonAccessData(&access, MON_DATA_SPEED_IV, NULL);
+    speedEV = GetBoxMonAccessData(&access, MON_DATA_SPEED_EV, NULL);
+    spAttackIV = GetBoxMonAccessData(&access, MON_DATA_SPATK_IV, NULL);
+    spAttackEV = GetBoxMonAccessData(&access, MON_DATA_SPATK_EV, NULL);
+    spDefenseIV = GetBoxMonAccessData(&access, MON_DATA_SPDEF_IV, NULL);
+    spDefenseEV = GetBoxMonAccessData(&access, MON_DATA_SPDEF_EV, NULL);
+    species = GetBoxMonAccessData(&access, MON_DATA_SPECIES, NULL);
+    level = GetLevelFromBoxMonAccessExp(&access);
 
     SetMonData(mon, MON_DATA_LEVEL, &level);
 
@@ -4171,20 +4249,21 @@ void BoxMonToMon(const struct BoxPokemon *src, struct Pokemon *dest)
 
 u8 GetLevelFromMonExp(struct Pokemon *mon)
 {
-    u16 species = GetMonData(mon, MON_DATA_SPECIES, NULL);
-    u32 exp = GetMonData(mon, MON_DATA_EXP, NULL);
-    s32 level = 1;
+    return GetLevelFromBoxMonExp(&mon->box);
+}
 
-    while (level <= MAX_LEVEL && gExperienceTables[gSpeciesInfo[species].growthRate][level] <= exp)
-        level++;
+u8 GetLevelFromBoxMonExp(struct BoxPokemon *boxMon)
+{
+    struct BoxMonAccess access;
 
-    return level - 1;
+    BeginBoxMonAccess(&access, boxMon);
+    return GetLevelFromBoxMonAccessExp(&access);
 }
 
-u8 GetLevelFromBoxMonExp(struct BoxPokemon *boxMon)
+u8 GetLevelFromBoxMonAccessExp(struct BoxMonAccess *access)
 {
-    u16 species = GetBoxMonData(boxMon, MON_DATA_SPECIES, NULL);
-    u32 exp = GetBoxMonData(boxMon, MON_DATA_EXP, NULL);
+    u16 species = GetBoxMonAccessData(access, MON_DATA_SPECIES, NULL);
+    u32 exp = GetBoxMonAccessData(access, MON_DATA_EXP, NULL);
     s32 level = 1;
 
     while (level <= MAX_LEVEL && gExperienceTables[gSpeciesInfo[species].growthRate][level] <= exp)
@@ -4677,7 +4756,16 @@ u32 GetMonData(struct Pokemon *mon, s32 field, u8 *data)
     return ret;
 }
 
-u32 GetBoxMonData(struct BoxPokemon *boxMon, s32 field, u8 *data)
+// Marks a mon whose checksum doesn't match as a Bad Egg. boxMon must be decrypted.
+static void MarkBoxMonAsBadEgg(struct BoxPokemon *boxMon)
+{
+    boxMon->isBadEgg = TRUE;
+    boxMon->isEgg = TRUE;
+    GetSubstruct(boxMon, boxMon->personality, 3)->type3.isEgg = TRUE;
+}
+
+// Reads a field from a BoxPokemon whose substructs have already been decrypted.
+static u32 GetDecryptedBoxMonData(struct BoxPokemon *boxMon, s32 field, u8 *data)
 {
     s32 i;
     u32 retVal = 0;
@@ -4686,22 +4774,12 @@ u32 GetBoxMonData(struct BoxPokemon *boxMon, s32 field, u8 *data)
     struct PokemonSubstruct2 *substruct2 = NULL;
     struct PokemonSubstruct3 *substruct3 = NULL;
 
-    // Any field greater than MON_DATA_ENCRYPT_SEPARATOR is encrypted and must be treated as such
     if (field > MON_DATA_ENCRYPT_SEPARATOR)
     {
         substruct0 = &(GetSubstruct(boxMon, boxMon->personality, 0)->type0);
         substruct1 = &(GetSubstruct(boxMon, boxMon->personality, 1)->type1);
         substruct2 = &(GetSubstruct(boxMon, boxMon->personality, 2)->type2);
         substruct3 = &(GetSubstruct(boxMon, boxMon->personality, 3)->type3);
-
-        DecryptBoxMon(boxMon);
-
-        if (CalculateBoxMonChecksum(boxMon) != boxMon->checksum)
-        {
-            boxMon->isBadEgg = TRUE;
-            boxMon->isEgg = TRUE;
-            substruct3->isEgg = TRUE;
-        }
     }
 
     switch (field)
@@ -5027,6 +5105,24 @@ u32 GetBoxMonData(struct BoxPokemon *boxMon, s32 field, u8 *data)
         break;
     }
 
+    return retVal;
+}
+
+u32 GetBoxMonData(struct BoxPokemon *boxMon, s32 field, u8 *data)
+{
+    u32 retVal;
+
+    // Any field greater than MON_DATA_ENCRYPT_SEPARATOR is encrypted and must be treated as such
+    if (field > MON_DATA_ENCRYPT_SEPARATOR)
+    {
+        DecryptBoxMon(boxMon);
+
+        if (CalculateBoxMonChecksum(boxMon) != boxMon->checksum)
+            MarkBoxMonAsBadEgg(boxMon);
+    }
+
+    retVal = GetDecryptedBoxMonData(boxMon, field, data);
+
     if (field > MON_DATA_ENCRYPT_SEPARATOR)
         EncryptBoxMon(boxMon);
 
@@ -5081,10 +5177,10 @@ void SetMonData(struct Pokemon *mon, s32 field, const void *dataArg)
     }
 }
 
-void SetBoxMonData(struct BoxPokemon *boxMon, s32 field, const void *dataArg)
+// Writes a field of a BoxPokemon whose substructs have already been decrypted.
+// The caller is responsible for updating the checksum.
+static void SetDecryptedBoxMonData(struct BoxPokemon *boxMon, s32 field, const u8 *data)
 {
-    const u8 *data = dataArg;
-
     struct PokemonSubstruct0 *substruct0 = NULL;
     struct PokemonSubstruct1 *substruct1 = NULL;
     struct PokemonSubstruct2 *substruct2 = NULL;
@@ -5096,17 +5192,6 @@ void SetBoxMonData(struct BoxPokemon *boxMon, s32 field, const void *dataArg)
         substruct1 = &(GetSubstruct(boxMon, boxMon->personality, 1)->type1);
         substruct2 = &(GetSubstruct(boxMon, boxMon->personality, 2)->type2);
         substruct3 = &(GetSubstruct(boxMon, boxMon->personality, 3)->type3);
-
-        DecryptBoxMon(boxMon);
-
-        if (CalculateBoxMonChecksum(boxMon) != boxMon->checksum)
-        {
-            boxMon->isBadEgg = TRUE;
-            boxMon->isEgg = TRUE;
-            substruct3->isEgg = TRUE;
-            EncryptBoxMon(boxMon);
-            return;
-        }
     }
 
     switch (field)
@@ -5344,6 +5429,23 @@ void SetBoxMonData(struct BoxPokemon *boxMon, s32 field, const void *dataArg)
     default:
         break;
     }
+}
+
+void SetBoxMonData(struct BoxPokemon *boxMon, s32 field, const void *dataArg)
+{
+    if (field > MON_DATA_ENCRYPT_SEPARATOR)
+    {
+        DecryptBoxMon(boxMon);
+
+        if (CalculateBoxMonChecksum(boxMon) != boxMon->checksum)
+        {
+            MarkBoxMonAsBadEgg(boxMon);
+            EncryptBoxMon(boxMon);
+            return;
+        }
+    }
+
+    SetDecryptedBoxMonData(boxMon, field, dataArg);
 
     if (field > MON_DATA_ENCRYPT_SEPARATOR)
     {
@@ -5352,6 +5454,63 @@ void SetBoxMonData(struct BoxPokemon *boxMon, s32 field, const void *dataArg)
     }
 }
 
+// Decrypts a copy of boxMon once, so that any number of fields can be read
+// or written without decrypting, checking and re-encrypting the mon for
+// each one. Changes are only written back by EndBoxMonAccess.
+void BeginBoxMonAccess(struct BoxMonAccess *access, struct BoxPokemon *boxMon)
+{
+    access->source = boxMon;
+    access->boxMon = *boxMon;
+    access->modified = FALSE;
+    access->secureModified = FALSE;
+    DecryptBoxMon(&access->boxMon);
+
+    access->isBadChecksum = (CalculateBoxMonChecksum(&access->boxMon) != access->boxMon.checksum);
+
+    if (access->isBadChecksum)
+    {
+        // Mark the original as well, as GetBoxMonData would have.
+        MarkBoxMonAsBadEgg(&access->boxMon);
+        *boxMon = access->boxMon;
+        EncryptBoxMon(boxMon);
+    }
+}
+
+u32 GetBoxMonAccessData(struct BoxMonAccess *access, s32 field, u8 *data)
+{
+    return GetDecryptedBoxMonData(&access->boxMon, field, data);
+}
+
+void SetBoxMonAccessData(struct BoxMonAccess *access, s32 field, const void *data)
+{
+    // Like SetBoxMonData, encrypted fields of a mon with a bad checksum can't be changed.
+    if (field > MON_DATA_ENCRYPT_SEPARATOR)
+    {
+        if (access->isBadChecksum)
+            return;
+
+        access->secureModified = TRUE;
+    }
+
+    SetDecryptedBoxMonData(&access->boxMon, field, data);
+    access->modified = TRUE;
+}
+
+// Only needed if fields were set.
+void EndBoxMonAccess(struct BoxMonAccess *access)
+{
+    if (access->modified)
+    {
+        if (access->secureModified)
+            access->boxMon.checksum = CalculateBoxMonChecksum(&access->boxMon);
+
+        *access->source = access->boxMon;
+        EncryptBoxMon(access->source);
+        access->modified = FALSE;
+        access->secureModified = FALSE;
+    }
+}
+
 void CopyMon(void *dest, void *src, size_t size)
 {
     memcpy(dest, src, size);
@@ -463,6 +463,7 @@ struct PokemonStorageSystemData
     u16 iconSpeciesList[MAX_MON_ICONS];
     u16 boxSpecies[IN_BOX_COUNT];
     u32 boxPersonalities[IN_BOX_COUNT];
+    u16 boxHeldItems[IN_BOX_COUNT];
     u8 incomingBoxId;
     u8 shiftTimer;
     u8 numPartyToCompact;
@@ -4455,6 +4456,7 @@ static void InitBoxMonSprites(u8 boxId)
     u16 i, j, count;
     u16 species;
     u32 personality;
+    struct BoxMonAccess access;
 
     count = 0;
     boxPosition = 0;
@@ -4464,11 +4466,18 @@ static void InitBoxMonSprites(u8 boxId)
     {
         for (j = 0; j < IN_BOX_COLUMNS; j++)
         {
-            species = GetBoxMonDataAt(boxId, boxPosition, MON_DATA_SPECIES2);
+            BeginBoxMonAccess(&access, &gPokemonStoragePtr->boxes[boxId][boxPosition]);
+            species = GetBoxMonAccessData(&access, MON_DATA_SPECIES2, NULL);
             if (species != SPECIES_NONE)
             {
-                personality = GetBoxMonDataAt(boxId, boxPosition, MON_DATA_PERSONALITY);
+                personality = GetBoxMonAccessData(&access, MON_DATA_PERSONALITY, NULL);
                 sStorage->boxMonsSprites[count] = CreateMonIconSprite(species, personality, 8 * (3 * j) + 100, 8 * (3 * i) + 44, 2, 19 - j);
+
+                // If in item mode, set all Pokémon icons with no item to be transparent
+                if (sStorage->boxOption == OPTION_MOVE_ITEMS
+                 && sStorage->boxMonsSprites[count] != NULL
+                 && GetBoxMonAccessData(&access, MON_DATA_HELD_ITEM, NULL) == ITEM_NONE)
+                    sStorage->boxMonsSprites[count]->oam.objMode = ST_OAM_OBJ_BLEND;
             }
             else
             {
@@ -4478,16 +4487,6 @@ static void InitBoxMonSprites(u8 boxId)
             count++;
         }
     }
-
-    // If in item mode, set all Pokémon icons with no item to be transparent
-    if (sStorage->boxOption == OPTION_MOVE_ITEMS)
-    {
-        for (boxPosition = 0; boxPosition < IN_BOX_COUNT; boxPosition++)
-        {
-            if (GetBoxMonDataAt(boxId, boxPosition, MON_DATA_HELD_ITEM) == ITEM_NONE)
-                sStorage->boxMonsSprites[boxPosition]->oam.objMode = ST_OAM_OBJ_BLEND;
-        }
-    }
 }
 
 static void CreateBoxMonIconAtPos(u8 boxPosition)
@@ -4630,7 +4629,7 @@ static u8 CreateBoxMonIconsInColumn(u8 column, u16 distance, s16 speed)
                     sStorage->boxMonsSprites[boxPosition]->sSpeed = speed;
                     sStorage->boxMonsSprites[boxPosition]->sScrollInDestX = xDest;
                     sStorage->boxMonsSprites[boxPosition]->callback = SpriteCB_BoxMonIconScrollIn;
-                    if (GetBoxMonDataAt(sStorage->incomingBoxId, boxPosition, MON_DATA_HELD_ITEM) == ITEM_NONE)
+                    if (sStorage->boxHeldItems[boxPosition] == ITEM_NONE)
                         sStorage->boxMonsSprites[boxPosition]->oam.objMode = ST_OAM_OBJ_BLEND;
                     iconsCreated++;
                 }
@@ -4720,15 +4719,20 @@ static bool8 UpdateBoxMonIconScroll(void)
 static void GetIncomingBoxMonData(u8 boxId)
 {
     s32 i, j, boxPosition;
+    struct BoxMonAccess access;
 
     boxPosition = 0;
     for (i = 0; i < IN_BOX_ROWS; i++)
     {
         for (j = 0; j < IN_BOX_COLUMNS; j++)
         {
-            sStorage->boxSpecies[boxPosition] = GetBoxMonDataAt(boxId, boxPosition, MON_DATA_SPECIES2);
+            BeginBoxMonAccess(&access, &gPokemonStoragePtr->boxes[boxId][boxPosition]);
+            sStorage->boxSpecies[boxPosition] = GetBoxMonAccessData(&access, MON_DATA_SPECIES2, NULL);
             if (sStorage->boxSpecies[boxPosition] != SPECIES_NONE)
-                sStorage->boxPersonalities[boxPosition] = GetBoxMonDataAt(boxId, boxPosition, MON_DATA_PERSONALITY);
+            {
+                sStorage->boxPersonalities[boxPosition] = GetBoxMonAccessData(&access, MON_DATA_PERSONALITY, NULL);
+                sStorage->boxHeldItems[boxPosition] = GetBoxMonAccessData(&access, MON_DATA_HELD_ITEM, NULL);
+            }
             boxPosition++;
         }
     }
@@ -6911,49 +6915,54 @@ static void SetDisplayMonData(void *pokemon, u8 mode)
     if (mode == MODE_PARTY)
     {
         struct Pokemon *mon = (struct Pokemon *)pokemon;
+        struct BoxMonAccess access;
 
-        sStorage->displayMonSpecies = GetMonData(mon, MON_DATA_SPECIES2);
+        BeginBoxMonAccess(&access, &mon->box);
+        sStorage->displayMonSpecies = GetBoxMonAccessData(&access, MON_DATA_SPECIES2, NULL);
         if (sStorage->displayMonSpecies != SPECIES_NONE)
         {
-            sanityIsBadEgg = GetMonData(mon, MON_DATA_SANITY_IS_BAD_EGG);
+            u32 otId = GetBoxMonAccessData(&access, MON_DATA_OT_ID, NULL);
+            sanityIsBadEgg = GetBoxMonAccessData(&access, MON_DATA_SANITY_IS_BAD_EGG, NULL);
             if (sanityIsBadEgg)
                 sStorage->displayMonIsEgg = TRUE;
             else
-                sStorage->displayMonIsEgg = GetMonData(mon, MON_DATA_IS_EGG);
+                sStorage->displayMonIsEgg = GetBoxMonAccessData(&access, MON_DATA_IS_EGG, NULL);
 
-            GetMonData(mon, MON_DATA_NICKNAME, sStorage->displayMonName);
+            GetBoxMonAccessData(&access, MON_DATA_NICKNAME, sStorage->displayMonName);
             StringGet_Nickname(sStorage->displayMonName);
             sStorage->displayMonLevel = GetMonData(mon, MON_DATA_LEVEL);
-            sStorage->displayMonMarkings = GetMonData(mon, MON_DATA_MARKINGS);
-            sStorage->displayMonPersonality = GetMonData(mon, MON_DATA_PERSONALITY);
-            sStorage->displayMonPalette = GetMonFrontSpritePal(mon);
-            gender = GetMonGender(mon);
-            sStorage->displayMonItemId = GetMonData(mon, MON_DATA_HELD_ITEM);
+            sStorage->displayMonMarkings = GetBoxMonAccessData(&access, MON_DATA_MARKINGS, NULL);
+            sStorage->displayMonPersonality = GetBoxMonAccessData(&access, MON_DATA_PERSONALITY, NULL);
+            sStorage->displayMonPalette = GetMonSpritePalFromSpeciesAndPersonality(sStorage->displayMonSpecies, otId, sStorage->displayMonPersonality);
+            gender = GetGenderFromSpeciesAndPersonality(GetBoxMonAccessData(&access, MON_DATA_SPECIES, NULL), sStorage->displayMonPersonality);
+            sStorage->displayMonItemId = GetBoxMonAccessData(&access, MON_DATA_HELD_ITEM, NULL);
         }
     }
     else if (mode == MODE_BOX)
     {
         struct BoxPokemon *boxMon = (struct BoxPokemon *)pokemon;
+        struct BoxMonAccess access;
 
-        sStorage->displayMonSpecies = GetBoxMonData(pokemon, MON_DATA_SPECIES2);
+        BeginBoxMonAccess(&access, boxMon);
+        sStorage->displayMonSpecies = GetBoxMonAccessData(&access, MON_DATA_SPECIES2, NULL);
         if (sStorage->displayMonSpecies != SPECIES_NONE)
         {
-            u32 otId = GetBoxMonData(boxMon, MON_DATA_OT_ID);
-            sanityIsBadEgg = GetBoxMonData(boxMon, MON_DATA_SANITY_IS_BAD_EGG);
+            u32 otId = GetBoxMonAccessData(&access, MON_DATA_OT_ID, NULL);
+            sanityIsBadEgg = GetBoxMonAccessData(&access, MON_DATA_SANITY_IS_BAD_EGG, NULL);
             if (sanityIsBadEgg)
                 sStorage->displayMonIsEgg = TRUE;
             else
-                sStorage->displayMonIsEgg = GetBoxMonData(boxMon, MON_DATA_IS_EGG);
+                sStorage->displayMonIsEgg = GetBoxMonAccessData(&access, MON_DATA_IS_EGG, NULL);
 
 
-            GetBoxMonData(boxMon, MON_DATA_NICKNAME, sStorage->displayMonName);
+            GetBoxMonAccessData(&access, MON_DATA_NICKNAME, sStorage->displayMonName);
             StringGet_Nickname(sStorage->displayMonName);
-            sStorage->displayMonLevel = GetLevelFromBoxMonExp(boxMon);
-            sStorage->displayMonMarkings = GetBoxMonData(boxMon, MON_DATA_MARKINGS);
-            sStorage->displayMonPersonality = GetBoxMonData(boxMon, MON_DATA_PERSONALITY);
+            sStorage->displayMonLevel = GetLevelFromBoxMonAccessExp(&access);
+            sStorage->displayMonMarkings = GetBoxMonAccessData(&access, MON_DATA_MARKINGS, NULL);
+            sStorage->displayMonPersonality = GetBoxMonAccessData(&access, MON_DATA_PERSONALITY, NULL);
             sStorage->displayMonPalette = GetMonSpritePalFromSpeciesAndPersonality(sStorage->displayMonSpecies, otId, sStorage->displayMonPersonality);
             gender = GetGenderFromSpeciesAndPersonality(sStorage->displayMonSpecies, sStorage->displayMonPersonality);
-            sStorage->displayMonItemId = GetBoxMonData(boxMon, MON_DATA_HELD_ITEM);
+            sStorage->displayMonItemId = GetBoxMonAccessData(&access, MON_DATA_HELD_ITEM, NULL);
         }
     }
     else
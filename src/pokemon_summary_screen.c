@@ -1468,32 +1468,36 @@ static bool8 ExtractMonDataToSummaryStruct(struct Pokemon *mon)
 {
     u32 i;
     struct PokeSummary *sum = &sMonSummaryScreen->summary;
+    struct BoxMonAccess access;
+
     // Spread the data extraction over multiple frames.
     switch (sMonSummaryScreen->switchCounter)
     {
     case 0:
-        sum->species = GetMonData(mon, MON_DATA_SPECIES);
-        sum->species2 = GetMonData(mon, MON_DATA_SPECIES2);
-        sum->exp = GetMonData(mon, MON_DATA_EXP);
+        BeginBoxMonAccess(&access, &mon->box);
+        sum->species = GetBoxMonAccessData(&access, MON_DATA_SPECIES, NULL);
+        sum->species2 = GetBoxMonAccessData(&access, MON_DATA_SPECIES2, NULL);
+        sum->exp = GetBoxMonAccessData(&access, MON_DATA_EXP, NULL);
         sum->level = GetMonData(mon, MON_DATA_LEVEL);
-        sum->abilityNum = GetMonData(mon, MON_DATA_ABILITY_NUM);
-        sum->item = GetMonData(mon, MON_DATA_HELD_ITEM);
-        sum->pid = GetMonData(mon, MON_DATA_PERSONALITY);
-        sum->sanity = GetMonData(mon, MON_DATA_SANITY_IS_BAD_EGG);
+        sum->abilityNum = GetBoxMonAccessData(&access, MON_DATA_ABILITY_NUM, NULL);
+        sum->item = GetBoxMonAccessData(&access, MON_DATA_HELD_ITEM, NULL);
+        sum->pid = GetBoxMonAccessData(&access, MON_DATA_PERSONALITY, NULL);
+        sum->sanity = GetBoxMonAccessData(&access, MON_DATA_SANITY_IS_BAD_EGG, NULL);
 
         if (sum->sanity)
             sum->isEgg = TRUE;
         else
-            sum->isEgg = GetMonData(mon, MON_DATA_IS_EGG);
+            sum->isEgg = GetBoxMonAccessData(&access, MON_DATA_IS_EGG, NULL);
 
         break;
     case 1:
+        BeginBoxMonAccess(&access, &mon->box);
         for (i = 0; i < MAX_MON_MOVES; i++)
         {
-            sum->moves[i] = GetMonData(mon, MON_DATA_MOVE1+i);
-            sum->pp[i] = GetMonData(mon, MON_DATA_PP1+i);
+            sum->moves[i] = GetBoxMonAccessData(&access, MON_DATA_MOVE1+i, NULL);
+            sum->pp[i] = GetBoxMonAccessData(&access, MON_DATA_PP1+i, NULL);
         }
-        sum->ppBonuses = GetMonData(mon, MON_DATA_PP_BONUSES);
+        sum->ppBonuses = GetBoxMonAccessData(&access, MON_DATA_PP_BONUSES, NULL);
         break;
     case 2:
         if (sMonSummaryScreen->monList.mons == gPlayerParty || sMonSummaryScreen->mode == SUMMARY_MODE_BOX || sMonSummaryScreen->handleDeoxys == TRUE)
@@ -1520,15 +1524,16 @@ static bool8 ExtractMonDataToSummaryStruct(struct Pokemon *mon)
         }
         break;
     case 3:
-        GetMonData(mon, MON_DATA_OT_NAME, sum->OTName);
-        ConvertInternationalString(sum->OTName, GetMonData(mon, MON_DATA_LANGUAGE));
+        BeginBoxMonAccess(&access, &mon->box);
+        GetBoxMonAccessData(&access, MON_DATA_OT_NAME, sum->OTName);
+        ConvertInternationalString(sum->OTName, GetBoxMonAccessData(&access, MON_DATA_LANGUAGE, NULL));
         sum->ailment = GetMonAilment(mon);
-        sum->OTGender = GetMonData(mon, MON_DATA_OT_GENDER);
-        sum->OTID = GetMonData(mon, MON_DATA_OT_ID);
-        sum->metLocation = GetMonData(mon, MON_DATA_MET_LOCATION);
-        sum->metLevel = GetMonData(mon, MON_DATA_MET_LEVEL);
-        sum->metGame = GetMonData(mon, MON_DATA_MET_GAME);
-        sum->friendship = GetMonData(mon, MON_DATA_FRIENDSHIP);
+        sum->OTGender = GetBoxMonAccessData(&access, MON_DATA_OT_GENDER, NULL);
+        sum->OTID = GetBoxMonAccessData(&access, MON_DATA_OT_ID, NULL);
+        sum->metLocation = GetBoxMonAccessData(&access, MON_DATA_MET_LOCATION, NULL);
+        sum->metLevel = GetBoxMonAccessData(&access, MON_DATA_MET_LEVEL, NULL);
+        sum->metGame = GetBoxMonAccessData(&access, MON_DATA_MET_GAME, NULL);
+        sum->friendship = GetBoxMonAccessData(&access, MON_DATA_FRIENDSHIP, NULL);
         break;
     default:
         sum->ribbonCount = GetMonData(mon, MON_DATA_RIBBON_COUNT);
@@ -15,6 +15,23 @@ u16 Random(void)
     return gRngValue >> 16;
 }
 
+// Scales Random() into the range with a multiply, redrawing the few values
+// that would make some results more likely than others. The division is only
+// needed in the rare case a redraw might be.
+u16 RandomBelow(u16 range)
+{
+    u32 product = (u32)Random() * range;
+
+    if ((u16)product < range)
+    {
+        u16 threshold = (u16)(0x10000 - range) % range;
+
+        while ((u16)product < threshold)
+            product = (u32)Random() * range;
+    }
+    return product >> 16;
+}
+
 void SeedRng(u16 seed)
 {
     gRngValue = seed;
@@ -34,10 +34,14 @@ static u8 HandleReplaceSector(u16, const struct SaveSectorLocation *);
  *
  * There are two save slots for saving the player's game data. We alternate between
  * them each time the game is saved, so that if the current save slot is corrupt,
- * we can load the previous one. We also rotate the sectors in each save slot
- * so that the same data is not always being written to the same sector. This
- * might be done to reduce wear on the flash memory, but I'm not sure, since all
- * 14 sectors get written anyway.
+ * we can load the previous one. The sectors in each save slot are rotated so that
+ * the same data is not always in the same sector.
+ *
+ * A normal save only rewrites the sectors of the older slot whose contents differ
+ * from what is being saved, keeping that slot's rotation. The SaveBlock2 sector
+ * carries the slot's counter and is always written last, so it acts as the commit
+ * record: a slot with any sector newer than its SaveBlock2 sector was interrupted
+ * and is not loaded.
  *
  * See SECTOR_ID_* constants in save.h
  */
@@ -136,10 +140,71 @@ static bool32 SetDamagedSectorBits(u8 op, u8 sectorId)
     return retVal;
 }
 
+// Reads the footer of a sector into gReadWriteSector, leaving its data alone.
+static void ReadFlashSectorFooter(u16 sector)
+{
+    ReadFlash(sector, offsetof(struct SaveSector, id), (u8 *)&gReadWriteSector->id, SECTOR_SIZE - offsetof(struct SaveSector, id));
+}
+
+// Returns the rotation the slot's sectors already have, so that unchanged
+// sectors can stay where they are. Any SaveBlock2 sector that would make the slot
+// look newer than the save about to be written (left by an interrupted save)
+// is erased first, so the slot can't load until the new SaveBlock2 sector is in.
+static u16 PrepareSaveSlotForWrite(u16 slotOffset)
+{
+    u16 i;
+    u16 rotation = NUM_SECTORS_PER_SLOT;
+
+    for (i = 0; i < NUM_SECTORS_PER_SLOT; i++)
+    {
+        ReadFlashSectorFooter(i + slotOffset);
+        if (gReadWriteSector->signature != SECTOR_SIGNATURE || gReadWriteSector->id >= NUM_SECTORS_PER_SLOT)
+            continue;
+
+        if (rotation == NUM_SECTORS_PER_SLOT)
+            rotation = (i + NUM_SECTORS_PER_SLOT - gReadWriteSector->id) % NUM_SECTORS_PER_SLOT;
+
+        if (gReadWriteSector->id == SECTOR_ID_SAVEBLOCK2 && (s32)(gReadWriteSector->counter - gSaveCounter) >= 0)
+            EraseFlashSector(i + slotOffset);
+    }
+
+    // Empty slot, rotate from the last one written
+    if (rotation == NUM_SECTORS_PER_SLOT)
+        rotation = (gLastWrittenSector + 1) % NUM_SECTORS_PER_SLOT;
+
+    return rotation;
+}
+
+static bool32 IsSaveSectorUnchanged(u16 sector, u16 sectorId, const struct SaveSectorLocation *locations)
+{
+    u16 i;
+    u8 *data = locations[sectorId].data;
+    u16 size = locations[sectorId].size;
+
+    ReadFlashSectorFooter(sector);
+    if (gReadWriteSector->signature != SECTOR_SIGNATURE
+     || gReadWriteSector->id != sectorId
+     || gReadWriteSector->checksum != CalculateChecksum(data, size)
+     || (s32)(gReadWriteSector->counter - gSaveCounter) > 0)
+        return FALSE;
+
+    // The checksum is only a 16-bit sum, so compare the data itself before keeping the sector
+    ReadFlash(sector, 0, gReadWriteSector->data, size);
+    for (i = 0; i < size; i++)
+    {
+        if (gReadWriteSector->data[i] != data[i])
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
 static u8 WriteSaveSectorOrSlot(u16 sectorId, const struct SaveSectorLocation *locations)
 {
     u32 status;
     u16 i;
+    u16 sector;
+    u16 slotOffset;
 
     gReadWriteSector = &gSaveDataBuffer;
 
@@ -154,13 +219,25 @@ static u8 WriteSaveSectorOrSlot(u16 sectorId, const struct SaveSectorLocation *l
         // No sector was specified, write full save slot.
         gLastKnownGoodSector = gLastWrittenSector; // backup the current written sector before attempting to write.
         gLastSaveCounter = gSaveCounter;
-        gLastWrittenSector++;
-        gLastWrittenSector = gLastWrittenSector % NUM_SECTORS_PER_SLOT;
         gSaveCounter++;
+        slotOffset = NUM_SECTORS_PER_SLOT * (gSaveCounter % NUM_SAVE_SLOTS);
+        gLastWrittenSector = PrepareSaveSlotForWrite(slotOffset);
         status = SAVE_STATUS_OK;
 
-        for (i = 0; i < NUM_SECTORS_PER_SLOT; i++)
-            HandleWriteSector(i, locations);
+        // Only rewrite the sectors that changed since this slot was last written.
+        for (i = SECTOR_ID_SAVEBLOCK2 + 1; i < NUM_SECTORS_PER_SLOT; i++)
+        {
+            sector = (i + gLastWrittenSector) % NUM_SECTORS_PER_SLOT + slotOffset;
+            if (IsSaveSectorUnchanged(sector, i, locations))
+                SetDamagedSectorBits(DISABLE, sector);
+            else
+                HandleWriteSector(i, locations);
+        }
+
+        // SaveBlock2 holds the new counter, which makes the slot valid again.
+        // Leave it alone if any other sector of the slot failed.
+        if (!(gDamagedSaveSectors & (((1 << NUM_SECTORS_PER_SLOT) - 1) << slotOffset)))
+            HandleWriteSector(SECTOR_ID_SAVEBLOCK2, locations);
 
         if (gDamagedSaveSectors)
         {
@@ -243,14 +320,18 @@ static u8 TryWriteSector(u8 sector, u8 *data)
     }
 }
 
+// Link saves write SaveBlock2 first, so the slot has to be given a different
+// rotation: until the last sector is in, some sector id is then missing from
+// the slot and it can't load as a mix of the old and the new save.
 static u32 RestoreSaveBackupVarsAndIncrement(const struct SaveSectorLocation *locations)
 {
     gReadWriteSector = &gSaveDataBuffer;
     gLastKnownGoodSector = gLastWrittenSector;
     gLastSaveCounter = gSaveCounter;
+    gSaveCounter++;
+    gLastWrittenSector = PrepareSaveSlotForWrite(NUM_SECTORS_PER_SLOT * (gSaveCounter % NUM_SAVE_SLOTS));
     gLastWrittenSector++;
     gLastWrittenSector %= NUM_SECTORS_PER_SLOT;
-    gSaveCounter++;
     gIncrementalSectorId = 0;
     gDamagedSaveSectors = 0;
     return 0;
@@ -512,77 +593,48 @@ static u8 CopySaveSlotData(u16 sectorId, struct SaveSectorLocation *locations)
     return SAVE_STATUS_OK;
 }
 
-static u8 GetSaveValidStatus(const struct SaveSectorLocation *locations)
+// A slot is only OK if all of its sectors are valid and none of them is newer than
+// its SaveBlock2 sector, which is written last and holds the slot's counter.
+static u8 GetSaveSlotStatus(u16 slotOffset, const struct SaveSectorLocation *locations, u32 *slotCounter)
 {
     u16 i;
     u16 checksum;
-    u32 saveSlot1Counter = 0;
-    u32 saveSlot2Counter = 0;
+    u32 newestCounter = 0;
     u32 validSectorFlags = 0;
     bool8 signatureValid = FALSE;
-    u8 saveSlot1Status;
-    u8 saveSlot2Status;
 
-    // Check save slot 1
+    *slotCounter = 0;
     for (i = 0; i < NUM_SECTORS_PER_SLOT; i++)
     {
-        ReadFlashSector(i, gReadWriteSector);
+        ReadFlashSector(i + slotOffset, gReadWriteSector);
         if (gReadWriteSector->signature == SECTOR_SIGNATURE)
         {
             signatureValid = TRUE;
             checksum = CalculateChecksum(gReadWriteSector->data, locations[gReadWriteSector->id].size);
             if (gReadWriteSector->checksum == checksum)
             {
-                saveSlot1Counter = gReadWriteSector->counter;
+                if (gReadWriteSector->id == SECTOR_ID_SAVEBLOCK2)
+                    *slotCounter = gReadWriteSector->counter;
+                if (validSectorFlags == 0 || (s32)(gReadWriteSector->counter - newestCounter) > 0)
+                    newestCounter = gReadWriteSector->counter;
                 validSectorFlags |= 1 << gReadWriteSector->id;
             }
         }
     }
 
-    if (signatureValid)
-    {
-        if (validSectorFlags == (1 << NUM_SECTORS_PER_SLOT) - 1)
-            saveSlot1Status = SAVE_STATUS_OK;
-        else
-            saveSlot1Status = SAVE_STATUS_ERROR;
-    }
-    else
-    {
-        // No sectors in slot 1 have the correct signature, treat it as empty
-        saveSlot1Status = SAVE_STATUS_EMPTY;
-    }
-
-    validSectorFlags = 0;
-    signatureValid = FALSE;
-
-    // Check save slot 2
-    for (i = 0; i < NUM_SECTORS_PER_SLOT; i++)
-    {
-        ReadFlashSector(i + NUM_SECTORS_PER_SLOT, gReadWriteSector);
-        if (gReadWriteSector->signature == SECTOR_SIGNATURE)
-        {
-            signatureValid = TRUE;
-            checksum = CalculateChecksum(gReadWriteSector->data, locations[gReadWriteSector->id].size);
-            if (gReadWriteSector->checksum == checksum)
-            {
-                saveSlot2Counter = gReadWriteSector->counter;
-                validSectorFlags |= 1 << gReadWriteSector->id;
-            }
-        }
-    }
+    if (!signatureValid)
+        return SAVE_STATUS_EMPTY; // No sectors in the slot have the correct signature, treat it as empty
+    if (validSectorFlags != (1 << NUM_SECTORS_PER_SLOT) - 1 || newestCounter != *slotCounter)
+        return SAVE_STATUS_ERROR;
+    return SAVE_STATUS_OK;
+}
 
-    if (signatureValid)
-    {
-        if (validSectorFlags == (1 << NUM_SECTORS_PER_SLOT) - 1)
-            saveSlot2Status = SAVE_STATUS_OK;
-        else
-            saveSlot2Status = SAVE_STATUS_ERROR;
-    }
-    else
-    {
-        // No sectors in slot 2 have the correct signature, treat it as empty.
-        saveSlot2Status = SAVE_STATUS_EMPTY;
-    }
+static u8 GetSaveValidStatus(const struct SaveSectorLocation *locations)
+{
+    u32 saveSlot1Counter;
+    u32 saveSlot2Counter;
+    u8 saveSlot1Status = GetSaveSlotStatus(0, locations, &saveSlot1Counter);
+    u8 saveSlot2Status = GetSaveSlotStatus(NUM_SECTORS_PER_SLOT, locations, &saveSlot2Counter);
 
     if (saveSlot1Status == SAVE_STATUS_OK && saveSlot2Status == SAVE_STATUS_OK)
     {
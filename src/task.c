@@ -1,10 +1,26 @@
 #include "global.h"
+#include "main.h"
 #include "task.h"
 
+STATIC_ASSERT(NUM_TASKS < HEAD_SENTINEL, TaskIdsBelowSentinels);
+
 struct Task gTasks[NUM_TASKS];
 
+// The head of the list RunTasks walks, and a list of the unused tasks so
+// CreateTask doesn't have to search for one. A destroyed task keeps its
+// prev/next links, since RunTasks follows next after a task destroys itself.
+static u8 sFirstTaskId;
+static u8 sFirstFreeTaskId;
+static u8 sNextFreeTaskIds[NUM_TASKS];
+static u8 sActiveTaskCount;
+static u8 sPeakActiveTaskCount;
+static u16 sFailedCreateCount;
+
+#if DEBUG_TASK_PROFILING == TRUE
+static EWRAM_DATA struct TaskProfile sTaskProfiles[TASK_PROFILE_COUNT] = {0};
+#endif
+
 static void InsertTask(u8 newTaskId);
-static u8 FindFirstActiveTask(void);
 
 void ResetTasks(void)
 {
@@ -18,41 +34,52 @@ void ResetTasks(void)
         gTasks[i].next = i + 1;
         gTasks[i].priority = -1;
         memset(gTasks[i].data, 0, sizeof(gTasks[i].data));
+        sNextFreeTaskIds[i] = i + 1;
     }
 
     gTasks[0].prev = HEAD_SENTINEL;
     gTasks[NUM_TASKS - 1].next = TAIL_SENTINEL;
+    sNextFreeTaskIds[NUM_TASKS - 1] = TAIL_SENTINEL;
+    sFirstFreeTaskId = 0;
+    sFirstTaskId = TAIL_SENTINEL;
+    sActiveTaskCount = 0;
 }
 
 u8 CreateTask(TaskFunc func, u8 priority)
 {
-    u8 i;
+    u8 taskId = sFirstFreeTaskId;
 
-    for (i = 0; i < NUM_TASKS; i++)
+    if (taskId == TAIL_SENTINEL)
     {
-        if (!gTasks[i].isActive)
-        {
-            gTasks[i].func = func;
-            gTasks[i].priority = priority;
-            InsertTask(i);
-            memset(gTasks[i].data, 0, sizeof(gTasks[i].data));
-            gTasks[i].isActive = TRUE;
-            return i;
-        }
+        // Nothing checks for failure, so this still hands out task 0.
+        DebugPrintfLevel(MGBA_LOG_ERROR, "CreateTask: all %d tasks are in use", NUM_TASKS);
+        sFailedCreateCount++;
+        return 0;
     }
 
-    return 0;
+    sFirstFreeTaskId = sNextFreeTaskIds[taskId];
+    gTasks[taskId].func = func;
+    gTasks[taskId].priority = priority;
+    InsertTask(taskId);
+    memset(gTasks[taskId].data, 0, sizeof(gTasks[taskId].data));
+    gTasks[taskId].isActive = TRUE;
+
+    if (++sActiveTaskCount > sPeakActiveTaskCount)
+        sPeakActiveTaskCount = sActiveTaskCount;
+
+    return taskId;
 }
 
 static void InsertTask(u8 newTaskId)
 {
-    u8 taskId = FindFirstActiveTask();
+    u8 taskId = sFirstTaskId;
 
-    if (taskId == NUM_TASKS)
+    if (taskId == TAIL_SENTINEL)
     {
         // The new task is the only task.
         gTasks[newTaskId].prev = HEAD_SENTINEL;
         gTasks[newTaskId].next = TAIL_SENTINEL;
+        sFirstTaskId = newTaskId;
         return;
     }
 
@@ -66,6 +93,8 @@ static void InsertTask(u8 newTaskId)
             gTasks[newTaskId].next = taskId;
             if (gTasks[taskId].prev != HEAD_SENTINEL)
                 gTasks[gTasks[taskId].prev].next = newTaskId;
+            else
+                sFirstTaskId = newTaskId;
             gTasks[taskId].prev = newTaskId;
             return;
         }
@@ -91,6 +120,7 @@ void DestroyTask(u8 taskId)
         {
             if (gTasks[taskId].next != TAIL_SENTINEL)
                 gTasks[gTasks[taskId].next].prev = HEAD_SENTINEL;
+            sFirstTaskId = gTasks[taskId].next;
         }
         else
         {
@@ -104,32 +134,63 @@ void DestroyTask(u8 taskId)
                 gTasks[gTasks[taskId].next].prev = gTasks[taskId].prev;
             }
         }
+
+        sNextFreeTaskIds[taskId] = sFirstFreeTaskId;
+        sFirstFreeTaskId = taskId;
+        sActiveTaskCount--;
     }
 }
 
-void RunTasks(void)
+#if DEBUG_TASK_PROFILING == TRUE
+static void CountTaskCycles(TaskFunc func, u32 cycles)
 {
-    u8 taskId = FindFirstActiveTask();
+    u32 i;
 
-    if (taskId != NUM_TASKS)
+    for (i = 0; i < TASK_PROFILE_COUNT; i++)
     {
-        do
+        if (sTaskProfiles[i].func == func || sTaskProfiles[i].func == NULL)
         {
-            gTasks[taskId].func(taskId);
-            taskId = gTasks[taskId].next;
-        } while (taskId != TAIL_SENTINEL);
+            sTaskProfiles[i].func = func;
+            sTaskProfiles[i].calls++;
+            sTaskProfiles[i].totalCycles += cycles;
+            if (cycles > sTaskProfiles[i].peakCycles)
+                sTaskProfiles[i].peakCycles = cycles;
+            return;
+        }
     }
 }
 
-static u8 FindFirstActiveTask(void)
+static void RunTaskProfiled(u8 taskId)
 {
-    u8 taskId;
+    TaskFunc func = gTasks[taskId].func;
+    u32 cycles;
 
-    for (taskId = 0; taskId < NUM_TASKS; taskId++)
-        if (gTasks[taskId].isActive == TRUE && gTasks[taskId].prev == HEAD_SENTINEL)
-            break;
+    StartCycleCounter();
+    cycles = GetCycleCount();
+    func(taskId);
+    cycles = GetCycleCount() - cycles;
 
-    return taskId;
+    // A save in the middle of the task stops the counter.
+    if (IsCycleCounterRunning())
+        CountTaskCycles(func, cycles);
+}
+#endif
+
+void RunTasks(void)
+{
+    u8 taskId = sFirstTaskId;
+
+    FRAME_STAGE_START(FRAME_STAGE_TASKS);
+    while (taskId != TAIL_SENTINEL)
+    {
+#if DEBUG_TASK_PROFILING == TRUE
+        RunTaskProfiled(taskId);
+#else
+        gTasks[taskId].func(taskId);
+#endif
+        taskId = gTasks[taskId].next;
+    }
+    FRAME_STAGE_END(FRAME_STAGE_TASKS);
 }
 
 void TaskDummy(u8 taskId)
@@ -176,14 +237,7 @@ u8 FindTaskIdByFunc(TaskFunc func)
 
 u8 GetTaskCount(void)
 {
-    u8 i;
-    u8 count = 0;
-
-    for (i = 0; i < NUM_TASKS; i++)
-        if (gTasks[i].isActive == TRUE)
-            count++;
-
-    return count;
+    return sActiveTaskCount;
 }
 
 void SetWordTaskArg(u8 taskId, u8 dataElem, u32 value)
@@ -202,3 +256,28 @@ u32 GetWordTaskArg(u8 taskId, u8 dataElem)
     else
         return 0;
 }
+
+void GetTaskStats(struct TaskStats *stats)
+{
+    stats->activeTasks = sActiveTaskCount;
+    stats->peakActiveTasks = sPeakActiveTaskCount;
+    stats->failedCreates = sFailedCreateCount;
+}
+
+const struct TaskProfile *GetTaskProfiles(void)
+{
+#if DEBUG_TASK_PROFILING == TRUE
+    return sTaskProfiles;
+#else
+    return NULL;
+#endif
+}
+
+void ResetTaskStats(void)
+{
+    sPeakActiveTaskCount = sActiveTaskCount;
+    sFailedCreateCount = 0;
+#if DEBUG_TASK_PROFILING == TRUE
+    memset(sTaskProfiles, 0, sizeof(sTaskProfiles));
+#endif
+}
@@ -4,6 +4,12 @@
 #include "palette.h"
 #include "constants/rgb.h"
 
+// Blending tables for the two most recently used coefficient/color pairs.
+// A fade or weather change blends every palette with the same pair, so the
+// table is built once and then saves three multiplies per color.
+static struct BlendLut sBlendLuts[2];
+static u8 sBlendLutLastUsed;
+
 const u32 gBitTable[] =
 {
     1 << 0,
@@ -277,3 +283,68 @@ void BlendPalette(u16 palOffset, u16 numEntries, u8 coeff, u16 blendColor)
                                       b + (((data2->b - b) * coeff) >> 4));
     }
 }
+
+const struct BlendLut *GetBlendLut(u8 coeff, u16 blendColor)
+{
+    struct BlendLut *lut;
+    s32 r, g, b, i;
+
+    blendColor &= ~RGB_ALPHA;
+    for (i = 0; i < (s32)ARRAY_COUNT(sBlendLuts); i++)
+    {
+        lut = &sBlendLuts[i];
+        if (lut->valid && lut->coeff == coeff && lut->color == blendColor)
+        {
+            sBlendLutLastUsed = i;
+            return lut;
+        }
+    }
+
+    sBlendLutLastUsed ^= 1;
+    lut = &sBlendLuts[sBlendLutLastUsed];
+    lut->valid = TRUE;
+    lut->coeff = coeff;
+    lut->color = blendColor;
+
+    // Same arithmetic as BlendPalette, so the results match for any coeff.
+    r = GET_R(blendColor);
+    g = GET_G(blendColor);
+    b = GET_B(blendColor);
+    for (i = 0; i < 32; i++)
+    {
+        lut->r[i] = i + (((r - i) * coeff) >> 4);
+        lut->g[i] = (i + (((g - i) * coeff) >> 4)) << 5;
+        lut->b[i] = (i + (((b - i) * coeff) >> 4)) << 10;
+    }
+    return lut;
+}
+
+#define BLEND_WITH_LUT(lut, color) ((lut)->r[GET_R(color)] | (lut)->g[GET_G(color)] | (lut)->b[GET_B(color)])
+
+// Gives the same colors as BlendPalette, two at a time. Worth it when blending
+// more than a palette or two with the same coefficient and color.
+void BlendPaletteWithLut(u16 palOffset, u16 numEntries, u8 coeff, u16 blendColor)
+{
+    const struct BlendLut *lut = GetBlendLut(coeff, blendColor);
+    const u16 *src = &gPlttBufferUnfaded[palOffset];
+    u16 *dest = &gPlttBufferFaded[palOffset];
+    u32 colors;
+
+    if ((palOffset & 1) && numEntries != 0)
+    {
+        *dest++ = BLEND_WITH_LUT(lut, *src);
+        src++;
+        numEntries--;
+    }
+
+    for (; numEntries >= 2; numEntries -= 2)
+    {
+        colors = *(const u32 *)src;
+        *(u32 *)dest = BLEND_WITH_LUT(lut, colors) | (BLEND_WITH_LUT(lut, colors >> 16) << 16);
+        src += 2;
+        dest += 2;
+    }
+
+    if (numEntries != 0)
+        *dest = BLEND_WITH_LUT(lut, *src);
+}
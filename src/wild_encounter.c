@@ -351,32 +351,28 @@ static u8 ChooseWildMonLevel(const struct WildPokemon *wildPokemon, u8 wildMonIn
 
 static u16 GetCurrentMapWildMonHeaderId(void)
 {
+    u8 mapGroup = gSaveBlock1Ptr->location.mapGroup;
+    u8 mapNum = gSaveBlock1Ptr->location.mapNum;
     u16 i;
 
-    for (i = 0; ; i++)
-    {
-        const struct WildPokemonHeader *wildHeader = &gWildMonHeaders[i];
-        if (wildHeader->mapGroup == MAP_GROUP(UNDEFINED))
-            break;
+    if (mapGroup >= MAP_GROUPS_COUNT || mapNum >= MAX_MAPS_IN_GROUP)
+        return HEADER_NONE;
 
-        if (gWildMonHeaders[i].mapGroup == gSaveBlock1Ptr->location.mapGroup &&
-            gWildMonHeaders[i].mapNum == gSaveBlock1Ptr->location.mapNum)
-        {
-            if (gSaveBlock1Ptr->location.mapGroup == MAP_GROUP(ALTERING_CAVE) &&
-                gSaveBlock1Ptr->location.mapNum == MAP_NUM(ALTERING_CAVE))
-            {
-                u16 alteringCaveId = VarGet(VAR_ALTERING_CAVE_WILD_SET);
-                if (alteringCaveId >= NUM_ALTERING_CAVE_TABLES)
-                    alteringCaveId = 0;
+    i = gWildMonHeadersByMap[mapGroup][mapNum];
+    if (i == 0)
+        return HEADER_NONE;
+    i--;
 
-                i += alteringCaveId;
-            }
+    if (mapGroup == MAP_GROUP(ALTERING_CAVE) && mapNum == MAP_NUM(ALTERING_CAVE))
+    {
+        u16 alteringCaveId = VarGet(VAR_ALTERING_CAVE_WILD_SET);
+        if (alteringCaveId >= NUM_ALTERING_CAVE_TABLES)
+            alteringCaveId = 0;
 
-            return i;
-        }
+        i += alteringCaveId;
     }
 
-    return HEADER_NONE;
+    return i;
 }
 
 static u8 PickWildMonNature(void)
@@ -0,0 +1,425 @@
+// Runs seeded battles between random parties on the host and times the
+// battle AI's decisions.
+//
+// The battle scripts are ARM assembly holding 32-bit pointers, so they can't
+// run here. Instead each turn asks the AI (and a greedy stand-in for the
+// player) for a move and applies it directly through the damage calc. That
+// exercises the same code the AI spends its time in on hardware: the damage
+// matrix in GetAiLogicData and the scoring in ComputeBattleAiScores.
+
+#include <stdlib.h>
+#include <string.h>
+#include "global.h"
+#include "battle.h"
+#include "battle_ai_main.h"
+#include "battle_anim.h"
+#include "battle_util.h"
+#include "main.h"
+#include "malloc.h"
+#include "pokemon.h"
+#include "random.h"
+#include "util.h"
+#include "constants/battle_ai.h"
+#include "constants/moves.h"
+#include "constants/species.h"
+#include "battle_sim.h"
+
+void AllocateBattleResources(void);
+void FreeBattleResources(void);
+
+struct SimStats
+{
+    u32 battles;
+    u32 turns;
+    u32 decisions;
+    u64 logicDataNs;
+    u64 scoreNs;
+    u64 worstDecisionNs;
+    u32 playerWins;
+    u32 opponentWins;
+    u32 draws;
+};
+
+static struct SimStats sStats;
+static u32 sMaxTurns = 100;
+static u8 sPartySize = PARTY_SIZE;
+
+u16 GetRandomSpecies(void)
+{
+    u16 species;
+
+    do
+    {
+        species = 1 + Random() % (FORMS_START - 1);
+    } while (gSpeciesInfo[species].baseHP == 0);
+
+    return species;
+}
+
+static void CreateRandomParty(struct Pokemon *party)
+{
+    u32 i;
+
+    ZeroMonData(&party[0]);
+    for (i = 0; i < PARTY_SIZE; i++)
+    {
+        if (i < sPartySize)
+            CreateMon(&party[i], GetRandomSpecies(), SIM_LEVEL, USE_RANDOM_IVS, 0, 0, OT_ID_RANDOM_NO_SHINY, 0);
+        else
+            ZeroMonData(&party[i]);
+    }
+}
+
+static struct Pokemon *GetBattlerParty(u32 battler)
+{
+    return GetBattlerSide(battler) == B_SIDE_PLAYER ? gPlayerParty : gEnemyParty;
+}
+
+static bool32 IsPartyIndexInBattle(u32 battler, u32 partyIndex)
+{
+    u32 i;
+
+    for (i = 0; i < gBattlersCount; i++)
+    {
+        if (GetBattlerSide(i) == GetBattlerSide(battler)
+         && gBattlerPartyIndexes[i] == partyIndex
+         && gBattleMons[i].hp != 0)
+            return TRUE;
+    }
+    return FALSE;
+}
+
+// Writes the battler's hp back to its party slot and, if it fainted, sends in
+// the next healthy party member. Returns FALSE if there is none.
+static bool32 UpdateBattlerMon(u32 battler)
+{
+    struct Pokemon *party = GetBattlerParty(battler);
+    u32 hp = gBattleMons[battler].hp;
+    u32 i;
+
+    SetMonData(&party[gBattlerPartyIndexes[battler]], MON_DATA_HP, &hp);
+    if (hp != 0)
+        return TRUE;
+
+    for (i = 0; i < sPartySize; i++)
+    {
+        if (GetMonData(&party[i], MON_DATA_HP) != 0 && !IsPartyIndexInBattle(battler, i))
+        {
+            gBattlerPartyIndexes[battler] = i;
+            PokemonToBattleMon(&party[i], &gBattleMons[battler]);
+            memset(&gDisableStructs[battler], 0, sizeof(gDisableStructs[battler]));
+            gStatuses3[battler] = 0;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static bool32 IsSideDefeated(u32 side)
+{
+    u32 i;
+
+    for (i = 0; i < gBattlersCount; i++)
+    {
+        if (GetBattlerSide(i) == side && gBattleMons[i].hp != 0)
+            return FALSE;
+    }
+    return TRUE;
+}
+
+static void InitBattle(bool32 isDouble)
+{
+    u32 i;
+
+    gMain.inBattle = TRUE;
+    gBattleTypeFlags = BATTLE_TYPE_TRAINER;
+    if (isDouble)
+        gBattleTypeFlags |= BATTLE_TYPE_DOUBLE | BATTLE_TYPE_INGAME_PARTNER;
+    gBattlersCount = isDouble ? MAX_BATTLERS_COUNT : 2;
+
+    CreateRandomParty(gPlayerParty);
+    CreateRandomParty(gEnemyParty);
+    gPlayerPartyCount = sPartySize;
+    gEnemyPartyCount = sPartySize;
+
+    AllocateBattleResources();
+    gFieldStatuses = 0;
+    memset(gSideStatuses, 0, sizeof(gSideStatuses));
+    memset(gSideTimers, 0, sizeof(gSideTimers));
+    memset(gDisableStructs, 0, sizeof(gDisableStructs));
+    memset(gStatuses3, 0, sizeof(gStatuses3));
+    gBattleWeather = 0;
+
+    for (i = 0; i < gBattlersCount; i++)
+    {
+        gBattlerPositions[i] = i;
+        gBattlerPartyIndexes[i] = i / 2;
+        PokemonToBattleMon(&GetBattlerParty(i)[i / 2], &gBattleMons[i]);
+    }
+
+    BattleAI_SetupFlags();
+    AI_THINKING_STRUCT->aiFlags = AI_FLAG_CHECK_BAD_MOVE | AI_FLAG_CHECK_VIABILITY | AI_FLAG_TRY_TO_FAINT | AI_FLAG_SMART_SWITCHING;
+    if (isDouble)
+        AI_THINKING_STRUCT->aiFlags |= AI_FLAG_DOUBLE_BATTLE;
+    Ai_InitPartyStruct();
+}
+
+// Stands in for the player: picks the usable move with the highest damage
+// roll against the first opposing battler still standing.
+static u32 ChooseGreedyMove(u32 battler, u8 *target)
+{
+    u32 i, def, bestMove = 0;
+    s32 bestDmg = -1;
+
+    for (def = 0; def < gBattlersCount; def++)
+    {
+        if (GetBattlerSide(def) != GetBattlerSide(battler) && gBattleMons[def].hp != 0)
+            break;
+    }
+    *target = def;
+
+    for (i = 0; i < MAX_MON_MOVES; i++)
+    {
+        u16 move = gBattleMons[battler].moves[i];
+        s32 dmg;
+
+        if (move == MOVE_NONE || gBattleMons[battler].pp[i] == 0)
+            continue;
+        gBattlerAttacker = battler;
+        gBattlerTarget = def;
+        gCurrentMove = move;
+        dmg = CalculateMoveDamage(move, battler, def, gBattleMoves[move].type, 0, FALSE, FALSE, FALSE);
+        if (dmg > bestDmg)
+        {
+            bestDmg = dmg;
+            bestMove = i;
+        }
+    }
+    return bestMove;
+}
+
+static void UseMove(u32 battler, u32 moveIndex, u32 target)
+{
+    u16 move = gBattleMons[battler].moves[moveIndex];
+    s32 dmg;
+
+    if (move == MOVE_NONE || gBattleMons[target].hp == 0 || battler == target)
+        return;
+
+    if (gBattleMons[battler].pp[moveIndex] != 0)
+        gBattleMons[battler].pp[moveIndex]--;
+
+    gBattlerAttacker = battler;
+    gBattlerTarget = target;
+    gCurrentMove = move;
+    gBattleMoveDamage = 0;
+    gMoveResultFlags = 0;
+    dmg = CalculateMoveDamage(move, battler, target, gBattleMoves[move].type, 0, FALSE, TRUE, FALSE);
+    if (dmg > gBattleMons[target].hp)
+        dmg = gBattleMons[target].hp;
+    gBattleMons[target].hp -= dmg;
+}
+
+static void RunTurn(void)
+{
+    u8 moveIndex[MAX_BATTLERS_COUNT];
+    u8 target[MAX_BATTLERS_COUNT];
+    u32 battler, i;
+    u64 start, afterLogic, end;
+
+    start = GetTimeNs();
+    GetAiLogicData();
+    afterLogic = GetTimeNs();
+    sStats.logicDataNs += afterLogic - start;
+
+    for (battler = 0; battler < gBattlersCount; battler++)
+    {
+        if (gBattleMons[battler].hp == 0)
+        {
+            moveIndex[battler] = MAX_MON_MOVES;
+            continue;
+        }
+
+        if (battler == B_POSITION_PLAYER_LEFT)
+        {
+            moveIndex[battler] = ChooseGreedyMove(battler, &target[battler]);
+            continue;
+        }
+
+        start = GetTimeNs();
+        gActiveBattler = battler;
+        moveIndex[battler] = ComputeBattleAiScores(battler);
+        target[battler] = gBattleStruct->aiChosenTarget[battler];
+        end = GetTimeNs();
+
+        sStats.scoreNs += end - start;
+        sStats.decisions++;
+        if (end - start > sStats.worstDecisionNs)
+            sStats.worstDecisionNs = end - start;
+    }
+
+    // Faster battlers move first.
+    for (i = 0; i < gBattlersCount; i++)
+        gBattlerByTurnOrder[i] = i;
+    for (i = 1; i < gBattlersCount; i++)
+    {
+        u32 j = i;
+
+        while (j > 0 && gBattleMons[gBattlerByTurnOrder[j]].speed > gBattleMons[gBattlerByTurnOrder[j - 1]].speed)
+        {
+            SWAP(gBattlerByTurnOrder[j], gBattlerByTurnOrder[j - 1], battler);
+            j--;
+        }
+    }
+
+    for (i = 0; i < gBattlersCount; i++)
+    {
+        battler = gBattlerByTurnOrder[i];
+        // Switching and fleeing aren't simulated, the battler just loses its turn.
+        if (gBattleMons[battler].hp != 0 && moveIndex[battler] < MAX_MON_MOVES)
+            UseMove(battler, moveIndex[battler], target[battler]);
+    }
+
+    for (battler = 0; battler < gBattlersCount; battler++)
+        UpdateBattlerMon(battler);
+
+    sStats.turns++;
+}
+
+static void RunBattle(bool32 isDouble)
+{
+    u32 turn;
+
+    InitBattle(isDouble);
+    for (turn = 0; turn < sMaxTurns; turn++)
+    {
+        RunTurn();
+        if (IsSideDefeated(B_SIDE_PLAYER) || IsSideDefeated(B_SIDE_OPPONENT))
+            break;
+    }
+
+    if (IsSideDefeated(B_SIDE_OPPONENT) && !IsSideDefeated(B_SIDE_PLAYER))
+        sStats.playerWins++;
+    else if (IsSideDefeated(B_SIDE_PLAYER) && !IsSideDefeated(B_SIDE_OPPONENT))
+        sStats.opponentWins++;
+    else
+        sStats.draws++;
+
+    FreeBattleResources();
+    sStats.battles++;
+}
+
+static void PrintStats(void)
+{
+    u32 decisions = sStats.decisions ? sStats.decisions : 1;
+    u32 turns = sStats.turns ? sStats.turns : 1;
+
+    printf("battles:             %u (player %u, opponent %u, draw %u)\n",
+           sStats.battles, sStats.playerWins, sStats.opponentWins, sStats.draws);
+    printf("turns:               %u\n", sStats.turns);
+    printf("ai decisions:        %u\n", sStats.decisions);
+    printf("GetAiLogicData:      %llu ns/turn\n", (unsigned long long)(sStats.logicDataNs / turns));
+    printf("ComputeBattleAiScores: %llu ns/decision (worst %llu ns)\n",
+           (unsigned long long)(sStats.scoreNs / decisions), (unsigned long long)sStats.worstDecisionNs);
+}
+
+static void Usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [-n battles] [-s seed] [-t max_turns] [-p party_size] [-d] [-P count] [-c count] [-w] [-S count] [-f count]\n", name);
+    fprintf(stderr, "  -d        double battles\n");
+    fprintf(stderr, "  -c count  create count wild mons instead of battling and count the RNG draws\n");
+    fprintf(stderr, "  -w        time the wild encounter header lookup instead of battling\n");
+    fprintf(stderr, "  -S count  make count saves, cutting the power at every step of each, instead of battling\n");
+    fprintf(stderr, "  -f count  time count full palette fades with and without the blend tables instead of battling\n");
+    fprintf(stderr, "  -P count  print the count most called functions (needs PROFILE=1)\n");
+    exit(1);
+}
+
+int main(int argc, char **argv)
+{
+    u32 numBattles = 100;
+    u32 seed = 0;
+    u32 profileCount = 0;
+    u32 personalityCount = 0;
+    u32 saveCount = 0;
+    u32 fadeCount = 0;
+    bool32 isDouble = FALSE;
+    bool32 wildHeaders = FALSE;
+    u32 i;
+    u64 start, end;
+
+    for (i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+
+        if (strcmp(arg, "-d") == 0)
+            isDouble = TRUE;
+        else if (strcmp(arg, "-w") == 0)
+            wildHeaders = TRUE;
+        else if (i + 1 >= argc)
+            Usage(argv[0]);
+        else if (strcmp(arg, "-n") == 0)
+            numBattles = strtoul(argv[++i], NULL, 0);
+        else if (strcmp(arg, "-s") == 0)
+            seed = strtoul(argv[++i], NULL, 0);
+        else if (strcmp(arg, "-t") == 0)
+            sMaxTurns = strtoul(argv[++i], NULL, 0);
+        else if (strcmp(arg, "-p") == 0)
+            sPartySize = strtoul(argv[++i], NULL, 0);
+        else if (strcmp(arg, "-P") == 0)
+            profileCount = strtoul(argv[++i], NULL, 0);
+        else if (strcmp(arg, "-c") == 0)
+            personalityCount = strtoul(argv[++i], NULL, 0);
+        else if (strcmp(arg, "-S") == 0)
+            saveCount = strtoul(argv[++i], NULL, 0);
+        else if (strcmp(arg, "-f") == 0)
+            fadeCount = strtoul(argv[++i], NULL, 0);
+        else
+            Usage(argv[0]);
+    }
+
+    if (sPartySize == 0 || sPartySize > PARTY_SIZE)
+        Usage(argv[0]);
+
+    HostInit();
+    gRngValue = seed;
+    ProfileReset();
+
+    if (wildHeaders)
+    {
+        RunWildHeaderBenchmark();
+        return 0;
+    }
+
+    if (saveCount != 0)
+    {
+        RunSaveTest(saveCount);
+        return 0;
+    }
+
+    if (fadeCount != 0)
+    {
+        RunFadeBenchmark(fadeCount);
+        return 0;
+    }
+
+    if (personalityCount != 0)
+    {
+        RunPersonalityBenchmark(personalityCount);
+        if (profileCount != 0)
+            ProfilePrint(stdout, profileCount);
+        return 0;
+    }
+
+    start = GetTimeNs();
+    for (i = 0; i < numBattles; i++)
+        RunBattle(isDouble);
+    end = GetTimeNs();
+
+    PrintStats();
+    printf("total:               %llu ms\n", (unsigned long long)((end - start) / 1000000));
+    if (profileCount != 0)
+        ProfilePrint(stdout, profileCount);
+
+    return 0;
+}
@@ -0,0 +1,23 @@
+#ifndef GUARD_BATTLE_SIM_H
+#define GUARD_BATTLE_SIM_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define SIM_LEVEL 50
+
+void HostInit(void);
+uint64_t GetTimeNs(void);
+
+uint16_t GetRandomSpecies(void);
+
+void RunPersonalityBenchmark(unsigned int count);
+void RunWildHeaderBenchmark(void);
+void RunFadeBenchmark(unsigned int count);
+
+void RunSaveTest(unsigned int count);
+
+void ProfileReset(void);
+void ProfilePrint(FILE *out, unsigned int count);
+
+#endif // GUARD_BATTLE_SIM_H
@@ -0,0 +1,54 @@
+// Times palette fades with and without the blend tables and checks that both
+// give the same colors.
+
+#include <string.h>
+#include "global.h"
+#include "palette.h"
+#include "random.h"
+#include "util.h"
+#include "battle_sim.h"
+
+// Times a fade of both full palette buffers through every coefficient, once
+// with BlendPalette and once with BlendPaletteWithLut, and checks that the two
+// give the same colors.
+void RunFadeBenchmark(u32 count)
+{
+    static u16 expected[PLTT_BUFFER_SIZE];
+    u32 i, j, mismatches = 0;
+    u64 start, plainNs = 0, lutNs = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        u16 color = Random() & 0x7FFF;
+
+        for (j = 0; j < PLTT_BUFFER_SIZE; j++)
+            gPlttBufferUnfaded[j] = Random();
+
+        for (j = 0; j <= 16; j++)
+        {
+            start = GetTimeNs();
+            BlendPalette(0, PLTT_BUFFER_SIZE, j, color);
+            plainNs += GetTimeNs() - start;
+            memcpy(expected, gPlttBufferFaded, sizeof(expected));
+
+            start = GetTimeNs();
+            BlendPaletteWithLut(0, PLTT_BUFFER_SIZE, j, color);
+            lutNs += GetTimeNs() - start;
+            if (memcmp(expected, gPlttBufferFaded, sizeof(expected)) != 0)
+                mismatches++;
+
+            // Odd offsets and lengths take the single color paths.
+            BlendPalette(1, PLTT_BUFFER_SIZE - 2, j, color);
+            memcpy(expected, gPlttBufferFaded, sizeof(expected));
+            BlendPaletteWithLut(1, PLTT_BUFFER_SIZE - 2, j, color);
+            if (memcmp(expected, gPlttBufferFaded, sizeof(expected)) != 0)
+                mismatches++;
+        }
+    }
+
+    count *= 17;
+    printf("fade steps:          %u of %u colors\n", count, PLTT_BUFFER_SIZE);
+    printf("BlendPalette:        %llu ns/step\n", (unsigned long long)(plainNs / (count ? count : 1)));
+    printf("BlendPaletteWithLut: %llu ns/step\n", (unsigned long long)(lutNs / (count ? count : 1)));
+    printf("mismatches:          %u\n", mismatches);
+}
@@ -0,0 +1,82 @@
+#!/bin/sh
+# usage: gen_stubs.sh OUTPUT ALLOWLIST OBJECTS...
+#
+# Writes a C file defining every symbol that OBJECTS use but don't define.
+# Symbols that are called become functions returning 0. Data symbols matching
+# a pattern in ALLOWLIST (battle scripts, graphics, text) become a block of
+# zeroed memory, and any other data symbol is an error. Anything the C
+# library provides is left for the linker.
+#
+# The stubbed symbols are listed as the file is generated, since a function
+# that the simulation actually needs links fine and just returns 0.
+
+set -ef
+
+out=$1
+allowlist=$2
+shift 2
+
+patterns=$(sed -e 's/#.*//' -e '/^[[:space:]]*$/d' "$allowlist")
+
+is_allowed() {
+    for pattern in $patterns; do
+        case "$1" in
+            $pattern)
+                return 0
+                ;;
+        esac
+    done
+    return 1
+}
+
+{
+    nm --defined-only "$@" | awk 'NF == 3 { print $3 }'
+    for lib in libc.so.6 libm.so.6; do
+        nm -D --defined-only "$(${CC:-cc} -print-file-name=$lib)" | awk 'NF == 3 { print $3 }' | sed 's/@.*//'
+    done
+} | sort -u > "$out.defined"
+objdump -r "$@" | awk '$2 == "R_X86_64_PLT32" { print $3 }' | sed 's/[-+]0x[0-9a-f]*$//' | sort -u > "$out.called"
+
+{
+    echo "/* Generated by gen_stubs.sh. Do not edit. */"
+    echo
+    echo "#define STUB_DATA_SIZE 0x1000"
+    echo
+    : > "$out.functions"
+    : > "$out.data"
+    : > "$out.unlisted"
+    nm -u "$@" | awk 'NF == 2 { print $2 }' | sort -u | comm -23 - "$out.defined" | while read -r sym; do
+        case "$sym" in
+            _GLOBAL_OFFSET_TABLE_|mem*|str*|__*)
+                ;;
+            *)
+                if grep -qx "$sym" "$out.called"; then
+                    echo "long $sym(void) { return 0; }"
+                    echo "$sym" >> "$out.functions"
+                elif is_allowed "$sym"; then
+                    echo "char $sym[STUB_DATA_SIZE] __attribute__((aligned(16)));"
+                    echo "$sym" >> "$out.data"
+                else
+                    echo "$sym" >> "$out.unlisted"
+                fi
+                ;;
+        esac
+    done
+} > "$out"
+
+echo "gen_stubs.sh: $(wc -l < "$out.functions") functions stubbed to return 0:"
+fmt -w 100 "$out.functions" | sed 's/^/    /'
+echo "gen_stubs.sh: $(wc -l < "$out.data") data symbols stubbed with zeroes:"
+fmt -w 100 "$out.data" | sed 's/^/    /'
+
+
+status=0
+if [ -s "$out.unlisted" ]; then
+    echo "gen_stubs.sh: data symbols not in $allowlist:" >&2
+    fmt -w 100 "$out.unlisted" | sed 's/^/    /' >&2
+    rm -f "$out"
+    status=1
+fi
+
+rm -f "$out.defined" "$out.called" "$out.functions" "$out.data" "$out.unlisted"
+exit $status
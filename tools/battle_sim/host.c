@@ -0,0 +1,116 @@
+// Host replacements for the parts of the GBA that the battle engine can't do
+// without: BIOS calls, the save block, the heap and the game state that
+// battle code reads but the simulator doesn't build the owners of.
+
+#include <string.h>
+#include <time.h>
+#include "global.h"
+#include "battle_setup.h"
+#include "decompress.h"
+#include "main.h"
+#include "malloc.h"
+#include "pokemon_storage_system.h"
+#include "rtc.h"
+#include "safari_zone.h"
+#include "trainer_hill.h"
+#include "battle_sim.h"
+
+struct SaveBlock1 *gSaveBlock1Ptr;
+struct SaveBlock2 *gSaveBlock2Ptr;
+struct PokemonStorage *gPokemonStoragePtr;
+
+// Defined in rom_header.s on hardware.
+const u8 gGameVersion = GAME_VERSION;
+const u8 gGameLanguage = GAME_LANGUAGE;
+
+struct Main gMain;
+struct MapHeader gMapHeader;
+struct Time gLocalTime;
+u16 gTrainerBattleOpponent_A;
+u16 gTrainerBattleOpponent_B;
+u16 gPartnerTrainerId;
+u8 gNumSafariBalls;
+u32 *gTrainerHillVBlankCounter;
+// The save code loads both Hall of Fame sectors in here.
+u8 gDecompressionBuffer[0x4000] __attribute__((aligned(4)));
+
+static struct SaveBlock1 sSaveBlock1;
+static struct SaveBlock2 sSaveBlock2;
+static struct PokemonStorage sPokemonStorage;
+static u8 sHeap[HEAP_SIZE] __attribute__((aligned(16)));
+
+void HostInit(void)
+{
+    memset(&sSaveBlock1, 0, sizeof(sSaveBlock1));
+    memset(&sSaveBlock2, 0, sizeof(sSaveBlock2));
+    memset(&sPokemonStorage, 0, sizeof(sPokemonStorage));
+    gSaveBlock1Ptr = &sSaveBlock1;
+    gSaveBlock2Ptr = &sSaveBlock2;
+    gPokemonStoragePtr = &sPokemonStorage;
+    InitHeap(sHeap, HEAP_SIZE);
+}
+
+// control: bits 0-20 are the count of units, bit 24 fills instead of copying
+// and bit 26 selects 32-bit units instead of 16-bit ones.
+void CpuSet(const void *src, void *dest, u32 control)
+{
+    u32 count = control & 0x1FFFFF;
+    u32 unitSize = (control & (1 << 26)) ? 4 : 2;
+    u32 i;
+
+    if (control & (1 << 24))
+    {
+        for (i = 0; i < count; i++)
+            memcpy((u8 *)dest + i * unitSize, src, unitSize);
+    }
+    else
+    {
+        memmove(dest, src, count * unitSize);
+    }
+}
+
+// Like CpuSet, but always in 32-bit units and the count is rounded up to 8.
+void CpuFastSet(const void *src, void *dest, u32 control)
+{
+    u32 count = ((control & 0x1FFFFF) + 7) & ~7;
+
+    CpuSet(src, dest, count | (1 << 26) | (control & (1 << 24)));
+}
+
+u64 GetTimeNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+u16 Sqrt(u32 num)
+{
+    u32 root = 0;
+    u32 bit = 1 << 30;
+
+    while (bit > num)
+        bit >>= 2;
+
+    while (bit != 0)
+    {
+        if (num >= root + bit)
+        {
+            num -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return root;
+}
+
+s32 Div(s32 num, s32 denom)
+{
+    return num / denom;
+}
@@ -0,0 +1,72 @@
+// Creates wild mons with forced natures, genders and Unown letters and counts
+// how many RNG draws each one takes.
+
+#include "global.h"
+#include "pokemon.h"
+#include "random.h"
+#include "constants/species.h"
+#include "battle_sim.h"
+
+static u32 CountRngSteps(u32 from, u32 to)
+{
+    u32 steps = 0;
+
+    while (from != to)
+    {
+        from = ISO_RANDOMIZE1(from);
+        steps++;
+    }
+    return steps;
+}
+
+// Creates mons the way wild encounters do (Synchronize, Cute Charm and Unown
+// letters) and reports how many RNG draws each one took.
+void RunPersonalityBenchmark(u32 count)
+{
+    struct Pokemon mon;
+    u32 i, draws, letterCount = 0;
+    u64 totalDraws = 0, letterDraws = 0;
+    u32 worstDraws = 0, worstLetterDraws = 0;
+    u64 start, end;
+
+    start = GetTimeNs();
+    for (i = 0; i < count; i++)
+    {
+        u16 species = GetRandomSpecies();
+        u8 nature = Random() % NUM_NATURES;
+        u8 gender = GetGenderFromSpeciesAndPersonality(species, Random32());
+        u32 rngValue;
+
+        if (i % 4 == 0)
+        {
+            u8 letter = 1 + Random() % NUM_UNOWN_FORMS;
+
+            rngValue = gRngValue;
+            CreateMonWithGenderNatureLetter(&mon, SPECIES_UNOWN, SIM_LEVEL, USE_RANDOM_IVS, MON_GENDERLESS, nature, letter);
+            draws = CountRngSteps(rngValue, gRngValue);
+            letterDraws += draws;
+            letterCount++;
+            if (draws > worstLetterDraws)
+                worstLetterDraws = draws;
+            continue;
+        }
+
+        rngValue = gRngValue;
+        if (i % 2 == 0)
+            CreateMonWithGenderNatureLetter(&mon, species, SIM_LEVEL, USE_RANDOM_IVS, gender, nature, 0);
+        else
+            CreateMonWithNature(&mon, species, SIM_LEVEL, USE_RANDOM_IVS, nature);
+        draws = CountRngSteps(rngValue, gRngValue);
+        totalDraws += draws;
+        if (draws > worstDraws)
+            worstDraws = draws;
+    }
+    end = GetTimeNs();
+
+    printf("mons created:        %u\n", count);
+    printf("nature/gender draws: %llu avg, %u worst\n",
+           (unsigned long long)(totalDraws / (count - letterCount ? count - letterCount : 1)), worstDraws);
+    printf("unown letter draws:  %llu avg, %u worst\n",
+           (unsigned long long)(letterDraws / (letterCount ? letterCount : 1)), worstLetterDraws);
+    printf("time:                %llu ns/mon\n", (unsigned long long)((end - start) / (count ? count : 1)));
+}
@@ -0,0 +1,122 @@
+// Call counts for the game code, collected through -finstrument-functions
+// when built with PROFILE=1. Only the game objects are instrumented, so the
+// harness and libc don't show up.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "battle_sim.h"
+
+#ifdef PROFILE
+
+#define PROFILE_TABLE_SIZE 0x4000
+
+struct ProfileEntry
+{
+    void *func;
+    unsigned long calls;
+    const char *name;
+};
+
+static struct ProfileEntry sProfileTable[PROFILE_TABLE_SIZE];
+
+void __cyg_profile_func_enter(void *func, void *callSite) __attribute__((no_instrument_function));
+void __cyg_profile_func_exit(void *func, void *callSite) __attribute__((no_instrument_function));
+
+void __cyg_profile_func_enter(void *func, void *callSite)
+{
+    unsigned long i = ((unsigned long)func >> 4) & (PROFILE_TABLE_SIZE - 1);
+
+    while (sProfileTable[i].func != func && sProfileTable[i].func != NULL)
+        i = (i + 1) & (PROFILE_TABLE_SIZE - 1);
+
+    sProfileTable[i].func = func;
+    sProfileTable[i].calls++;
+}
+
+void __cyg_profile_func_exit(void *func, void *callSite)
+{
+}
+
+void ProfileReset(void)
+{
+    memset(sProfileTable, 0, sizeof(sProfileTable));
+}
+
+// The simulator is linked without PIE, so the addresses from nm are the ones
+// the hooks see.
+static void ResolveNames(void)
+{
+    char exe[256];
+    char line[512];
+    ssize_t len = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+    FILE *nm;
+
+    if (len <= 0)
+        return;
+    exe[len] = '\0';
+
+    snprintf(line, sizeof(line), "nm --defined-only '%s'", exe);
+    nm = popen(line, "r");
+    if (nm == NULL)
+        return;
+
+    while (fgets(line, sizeof(line), nm) != NULL)
+    {
+        char name[448];
+        unsigned long addr;
+        char type;
+        int i;
+
+        if (sscanf(line, "%lx %c %447s", &addr, &type, name) != 3 || (type != 'T' && type != 't'))
+            continue;
+
+        for (i = 0; i < PROFILE_TABLE_SIZE; i++)
+        {
+            if ((unsigned long)sProfileTable[i].func == addr && sProfileTable[i].name == NULL)
+                sProfileTable[i].name = strdup(name);
+        }
+    }
+    pclose(nm);
+}
+
+static int CompareCalls(const void *a, const void *b)
+{
+    const struct ProfileEntry *x = a;
+    const struct ProfileEntry *y = b;
+
+    if (x->calls != y->calls)
+        return x->calls < y->calls ? 1 : -1;
+    return 0;
+}
+
+void ProfilePrint(FILE *out, unsigned int count)
+{
+    unsigned int i;
+
+    ResolveNames();
+    qsort(sProfileTable, PROFILE_TABLE_SIZE, sizeof(sProfileTable[0]), CompareCalls);
+
+    fprintf(out, "%12s  %s\n", "calls", "function");
+    for (i = 0; i < count && i < PROFILE_TABLE_SIZE && sProfileTable[i].calls != 0; i++)
+    {
+        if (sProfileTable[i].name != NULL)
+            fprintf(out, "%12lu  %s\n", sProfileTable[i].calls, sProfileTable[i].name);
+        else
+            fprintf(out, "%12lu  %p\n", sProfileTable[i].calls, sProfileTable[i].func);
+    }
+}
+
+#else
+
+void ProfileReset(void)
+{
+}
+
+void ProfilePrint(FILE *out, unsigned int count)
+{
+    fprintf(out, "no call counts: rebuild with PROFILE=1\n");
+}
+
+#endif // PROFILE
@@ -0,0 +1,236 @@
+// A simulated flash chip for save.c, and a test that cuts the power at every
+// step of a save to check that the game always loads either the old save or
+// the new one.
+
+#include <string.h>
+#include "global.h"
+#include "agb_flash.h"
+#include "gba/flash_internal.h"
+#include "load_save.h"
+#include "pokemon_storage_system.h"
+#include "random.h"
+#include "save.h"
+#include "battle_sim.h"
+
+#define FLASH_SECTOR_COUNT 32
+#define FLASH_SECTOR_SIZE  0x1000
+
+bool32 gFlashMemoryPresent = TRUE;
+
+static u8 sFlash[FLASH_SECTOR_COUNT][FLASH_SECTOR_SIZE];
+
+// Number of erase/program operations left before the power goes out, or -1
+// for no limit. The operation that runs out of power is either left half
+// done or never started, depending on sTornCut.
+static s32 sPowerBudget = -1;
+static bool32 sTornCut;
+static bool32 sPowerLost;
+static u32 sSectorsProgrammed;
+
+static bool32 UsePower(void)
+{
+    if (sPowerLost)
+        return FALSE;
+    if (sPowerBudget > 0)
+        sPowerBudget--;
+    else if (sPowerBudget == 0)
+    {
+        sPowerLost = TRUE;
+        return sTornCut;
+    }
+    return TRUE;
+}
+
+static u16 HostEraseFlashSector(u16 sectorNum)
+{
+    if (UsePower())
+        memset(sFlash[sectorNum], 0xFF, FLASH_SECTOR_SIZE);
+    return 0;
+}
+
+static u16 HostProgramFlashByte(u16 sectorNum, u32 offset, u8 data)
+{
+    if (UsePower())
+        sFlash[sectorNum][offset] &= data;
+    return 0;
+}
+
+u16 (*EraseFlashSector)(u16) = HostEraseFlashSector;
+u16 (*ProgramFlashByte)(u16, u32, u8) = HostProgramFlashByte;
+
+void ReadFlash(u16 sectorNum, u32 offset, u8 *dest, u32 size)
+{
+    memcpy(dest, &sFlash[sectorNum][offset], size);
+}
+
+// Like the real chips this erases the sector first. Losing power while
+// programming leaves only the first half of the sector written.
+u32 ProgramFlashSectorAndVerify(u16 sectorNum, u8 *src)
+{
+    u32 i;
+
+    HostEraseFlashSector(sectorNum);
+    if (!UsePower())
+        return 0;
+
+    sSectorsProgrammed++;
+    for (i = 0; i < (sPowerLost ? FLASH_SECTOR_SIZE / 2 : FLASH_SECTOR_SIZE); i++)
+        sFlash[sectorNum][i] &= src[i];
+    return 0;
+}
+
+struct SaveState
+{
+    struct SaveBlock1 saveBlock1;
+    struct SaveBlock2 saveBlock2;
+    struct PokemonStorage pokemonStorage;
+    u8 flash[FLASH_SECTOR_COUNT][FLASH_SECTOR_SIZE];
+    u32 saveCounter;
+    u16 lastWrittenSector;
+};
+
+static struct SaveState sOldState;
+static struct SaveState sNewState;
+static struct SaveState sNextState;
+
+static void StoreState(struct SaveState *state)
+{
+    state->saveBlock1 = *gSaveBlock1Ptr;
+    state->saveBlock2 = *gSaveBlock2Ptr;
+    state->pokemonStorage = *gPokemonStoragePtr;
+    memcpy(state->flash, sFlash, sizeof(sFlash));
+    state->saveCounter = gSaveCounter;
+    state->lastWrittenSector = gLastWrittenSector;
+}
+
+static void RestoreState(const struct SaveState *state)
+{
+    *gSaveBlock1Ptr = state->saveBlock1;
+    *gSaveBlock2Ptr = state->saveBlock2;
+    *gPokemonStoragePtr = state->pokemonStorage;
+    memcpy(sFlash, state->flash, sizeof(sFlash));
+    gSaveCounter = state->saveCounter;
+    gLastWrittenSector = state->lastWrittenSector;
+    gDamagedSaveSectors = 0;
+}
+
+static bool32 DoesSaveMatchState(const struct SaveState *state)
+{
+    return memcmp(gSaveBlock1Ptr, &state->saveBlock1, sizeof(state->saveBlock1)) == 0
+        && memcmp(gSaveBlock2Ptr, &state->saveBlock2, sizeof(state->saveBlock2)) == 0
+        && memcmp(gPokemonStoragePtr, &state->pokemonStorage, sizeof(state->pokemonStorage)) == 0;
+}
+
+static void RandomizeBytes(void *data, u32 size, u32 count)
+{
+    while (count-- != 0)
+        ((u8 *)data)[Random32() % size] = Random();
+}
+
+// Most saves only change a little: the play time and position always, the
+// flags and bag sometimes, the PC rarely.
+static void ChangeSaveData(u32 saveNum)
+{
+    RandomizeBytes(gSaveBlock2Ptr, sizeof(struct SaveBlock2), 4);
+    if (Random() % 2 == 0)
+        RandomizeBytes(gSaveBlock1Ptr, sizeof(struct SaveBlock1), 1 + Random() % 8);
+    if (Random() % 8 == 0)
+        RandomizeBytes(gPokemonStoragePtr, sizeof(struct PokemonStorage), 1 + Random() % 8);
+    if (saveNum % 32 == 0)
+    {
+        RandomizeBytes(gSaveBlock1Ptr, sizeof(struct SaveBlock1), sizeof(struct SaveBlock1));
+        RandomizeBytes(gPokemonStoragePtr, sizeof(struct PokemonStorage), sizeof(struct PokemonStorage));
+    }
+}
+
+// Writes the save the way link battles and the Battle Frontier do, spreading
+// it over several frames.
+static void LinkFullSave(void)
+{
+    LinkFullSave_Init();
+    while (!LinkFullSave_WriteSector())
+        ;
+    LinkFullSave_ReplaceLastSector();
+    LinkFullSave_SetLastSectorSignature();
+}
+
+// Every other save is a link save, so both ways of saving get written over
+// each other's slots.
+static void SaveGame(u32 saveNum)
+{
+    if (saveNum % 2 == 0)
+        LinkFullSave();
+    else
+        HandleSavingData(SAVE_NORMAL);
+}
+
+// Turns the power off and back on and loads the save, like the title screen does.
+static u8 Reboot(void)
+{
+    memset(gSaveBlock1Ptr, 0, sizeof(struct SaveBlock1));
+    memset(gSaveBlock2Ptr, 0, sizeof(struct SaveBlock2));
+    memset(gPokemonStoragePtr, 0, sizeof(struct PokemonStorage));
+    Save_ResetSaveCounters();
+    sPowerBudget = -1;
+    sPowerLost = FALSE;
+    return LoadGameSave(SAVE_NORMAL);
+}
+
+void RunSaveTest(unsigned int count)
+{
+    u32 i, steps, totalCuts = 0, totalSectors = 0, failures = 0;
+
+    memset(sFlash, 0xFF, sizeof(sFlash));
+    ChangeSaveData(0);
+    HandleSavingData(SAVE_NORMAL);
+    StoreState(&sOldState);
+
+    for (i = 1; i <= count; i++)
+    {
+        ChangeSaveData(i);
+        StoreState(&sNewState);
+
+        // Each step is tried twice, once with a clean cut and once torn.
+        for (steps = 0; ; steps++)
+        {
+            bool32 finished;
+            u8 status;
+
+            RestoreState(&sNewState);
+            sPowerBudget = steps / 2;
+            sTornCut = steps % 2;
+            sPowerLost = FALSE;
+            sSectorsProgrammed = 0;
+            SaveGame(i);
+            finished = !sPowerLost;
+            if (finished)
+                StoreState(&sNextState);
+
+            // An interrupted save leaves the slot it was writing corrupt, which
+            // the title screen reports before loading the other slot.
+            status = Reboot();
+            if (!(status == SAVE_STATUS_OK || (!finished && status == SAVE_STATUS_ERROR))
+             || !(DoesSaveMatchState(&sNewState) || (!finished && DoesSaveMatchState(&sOldState))))
+            {
+                printf("save %u: bad load after %u%s steps\n", i, steps / 2, sTornCut ? " and a half" : "");
+                failures++;
+            }
+
+            if (finished)
+                break;
+        }
+
+        totalCuts += steps;
+        totalSectors += sSectorsProgrammed;
+
+        // Carry on from the completed save, as if the game hadn't been turned off.
+        RestoreState(&sNextState);
+        sOldState = sNextState;
+    }
+
+    printf("saves:               %u\n", count);
+    printf("sectors written:     %u.%02u of %u per save\n", totalSectors / count,
+           totalSectors * 100 / count % 100, NUM_SECTORS_PER_SLOT);
+    printf("power cuts tested:   %u\n", totalCuts);
+    printf("bad loads:           %u\n", failures);
+}
@@ -0,0 +1,45 @@
+// Times the wild encounter header lookup for every map with encounters.
+
+#include "global.h"
+#include "wild_encounter.h"
+#include "constants/maps.h"
+#include "battle_sim.h"
+
+#define LOOKUP_REPEATS 10000
+
+// Times the wild encounter header lookup for every map with encounters, in
+// the order the maps appear in gWildMonHeaders.
+void RunWildHeaderBenchmark(void)
+{
+    u32 i, j, numHeaders, found = 0;
+    u64 start, end, totalNs = 0, firstNs = 0, lastNs = 0, worstNs = 0;
+
+    for (numHeaders = 0; gWildMonHeaders[numHeaders].mapGroup != MAP_GROUP(UNDEFINED); numHeaders++)
+        ;
+
+    for (i = 0; i < numHeaders; i++)
+    {
+        u64 ns;
+
+        gSaveBlock1Ptr->location.mapGroup = gWildMonHeaders[i].mapGroup;
+        gSaveBlock1Ptr->location.mapNum = gWildMonHeaders[i].mapNum;
+
+        start = GetTimeNs();
+        for (j = 0; j < LOOKUP_REPEATS; j++)
+            found += DoesCurrentMapHaveFishingMons();
+        end = GetTimeNs();
+
+        ns = (end - start) / LOOKUP_REPEATS;
+        totalNs += ns;
+        if (i == 0)
+            firstNs = ns;
+        lastNs = ns;
+        if (ns > worstNs)
+            worstNs = ns;
+    }
+
+    printf("headers:             %u (%u with fishing)\n", numHeaders, found / LOOKUP_REPEATS);
+    printf("lookup:              %llu ns avg, %llu ns first map, %llu ns last map, %llu ns worst\n",
+           (unsigned long long)(totalNs / (numHeaders ? numHeaders : 1)), (unsigned long long)firstNs,
+           (unsigned long long)lastNs, (unsigned long long)worstNs);
+}
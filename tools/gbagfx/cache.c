@@ -0,0 +1,335 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <utime.h>
+#include <time.h>
+#include "global.h"
+#include "util.h"
+#include "cache.h"
+
+#ifdef _WIN32
+#include <direct.h>
+#define MakeDirectory(path) _mkdir(path)
+#else
+#define MakeDirectory(path) mkdir(path, 0777)
+#endif
+
+// Converted files are stored in the cache directory under a hash of
+// everything that can affect the output: the gbagfx binary, the input and
+// output formats, the options, and the contents of the input file and of any
+// other file named by an option (such as -palette or -tilemap). Since nothing
+// in the key depends on timestamps, touching the inputs without changing them
+// turns a conversion into a copy.
+//
+// Every hit touches its entry, and once the directory grows past
+// CACHE_MAX_SIZE the least recently used entries are removed.
+
+#define CACHE_VERSION "gbagfx cache v2"
+
+#define CACHE_MAX_SIZE (256 * 1024 * 1024)
+
+static char *sCacheDir;
+static uint64_t sProgramStamp;
+static atomic_uint sTempFileCounter;
+static atomic_bool sPruneDue;
+
+static void HashBytes(uint64_t *hash, const void *data, size_t size)
+{
+	const unsigned char *bytes = data;
+
+	for (size_t i = 0; i < size; i++) {
+		*hash ^= bytes[i];
+		*hash *= 0x100000001B3ull;
+	}
+}
+
+// Strings are hashed with their length so that adjacent ones can't run together.
+static void HashString(uint64_t *hash, const char *s)
+{
+	uint64_t length = strlen(s);
+
+	HashBytes(hash, &length, sizeof(length));
+	HashBytes(hash, s, length);
+}
+
+static bool HashFileContents(uint64_t *hash, char *path)
+{
+	struct stat st;
+
+	if (stat(path, &st) != 0 || !S_ISREG(st.st_mode))
+		return false;
+
+	FILE *fp = fopen(path, "rb");
+
+	if (fp == NULL)
+		return false;
+
+	unsigned char buffer[0x4000];
+	size_t count;
+	uint64_t size = 0;
+
+	while ((count = fread(buffer, 1, sizeof(buffer), fp)) > 0) {
+		HashBytes(hash, buffer, count);
+		size += count;
+	}
+
+	fclose(fp);
+
+	HashBytes(hash, &size, sizeof(size));
+	return true;
+}
+
+void InitOutputCache(char *cacheDir, char *programPath)
+{
+	struct stat st;
+
+	sCacheDir = cacheDir;
+	sProgramStamp = 0xCBF29CE484222325ull;
+
+	// Rebuilding gbagfx can change its output, so the binary is part of every key.
+	if (stat(programPath, &st) == 0) {
+		uint64_t size = st.st_size;
+		uint64_t mtime = st.st_mtime;
+
+		HashBytes(&sProgramStamp, &size, sizeof(size));
+		HashBytes(&sProgramStamp, &mtime, sizeof(mtime));
+	}
+
+	// Create the directory and any missing parents.
+	char *path = malloc(strlen(cacheDir) + 1);
+
+	if (path == NULL)
+		FATAL_ERROR("Failed to allocate memory for cache path.\n");
+
+	strcpy(path, cacheDir);
+
+	for (char *p = path + 1; ; p++) {
+		if (*p == '/' || *p == 0) {
+			char c = *p;
+
+			*p = 0;
+
+			if (MakeDirectory(path) != 0 && errno != EEXIST)
+				FATAL_ERROR("Failed to create cache directory \"%s\".\n", path);
+
+			*p = c;
+
+			if (c == 0)
+				break;
+		}
+	}
+
+	free(path);
+}
+
+bool IsOutputCacheEnabled(void)
+{
+	return sCacheDir != NULL;
+}
+
+// argv has the command line layout: the input path, the output path and then the options.
+void GetOutputCacheKey(int argc, char **argv, char *outputPath, char *key)
+{
+	uint64_t hash = sProgramStamp;
+
+	HashString(&hash, CACHE_VERSION);
+
+	// The input extension picks the converter just as much as the output one does.
+	HashString(&hash, GetFileExtension(argv[1]));
+	HashString(&hash, GetFileExtension(outputPath));
+
+	if (!HashFileContents(&hash, argv[1]))
+		FATAL_ERROR("Failed to open \"%s\" for reading.\n", argv[1]);
+
+	for (int i = 3; i < argc; i++) {
+		HashString(&hash, argv[i]);
+		HashFileContents(&hash, argv[i]);
+	}
+
+	snprintf(key, CACHE_KEY_LENGTH + 1, "%016llx", (unsigned long long)hash);
+}
+
+static char *GetCachePath(char *key)
+{
+	size_t size = strlen(sCacheDir) + CACHE_KEY_LENGTH + 2;
+	char *path = malloc(size);
+
+	if (path == NULL)
+		FATAL_ERROR("Failed to allocate memory for cache path.\n");
+
+	snprintf(path, size, "%s/%s", sCacheDir, key);
+	return path;
+}
+
+// The entry is read without ReadWholeFile, since another gbagfx pruning the
+// cache may remove it at any time. That only turns the hit into a miss.
+bool RestoreCachedOutput(char *key, char *outputPath)
+{
+	char *cachePath = GetCachePath(key);
+	FILE *fp = fopen(cachePath, "rb");
+	bool found = false;
+
+	if (fp != NULL) {
+		struct stat st;
+
+		if (fstat(fileno(fp), &st) == 0 && st.st_size > 0) {
+			unsigned char *buffer = malloc(st.st_size);
+
+			if (buffer == NULL)
+				FATAL_ERROR("Failed to allocate memory for cached output.\n");
+
+			if (fread(buffer, st.st_size, 1, fp) == 1) {
+				WriteWholeFile(outputPath, buffer, st.st_size);
+				found = true;
+			}
+
+			free(buffer);
+		}
+
+		fclose(fp);
+	}
+
+	// Mark the entry as recently used for PruneOutputCache.
+	if (found)
+		utime(cachePath, NULL);
+
+	free(cachePath);
+	return found;
+}
+
+// Entries are written to a temporary file and renamed into place, so other
+// threads and processes sharing the cache never see a partial file.
+void StoreCachedOutput(char *key, char *outputPath)
+{
+	char *cachePath = GetCachePath(key);
+	size_t tempPathSize = strlen(cachePath) + 32;
+	char *tempPath = malloc(tempPathSize);
+
+	if (tempPath == NULL)
+		FATAL_ERROR("Failed to allocate memory for cache path.\n");
+
+	snprintf(tempPath, tempPathSize, "%s.%ld.%u.tmp", cachePath, (long)getpid(), atomic_fetch_add(&sTempFileCounter, 1));
+
+	struct stat st;
+
+	// Empty entries are treated as missing, so empty outputs are never stored.
+	if (stat(outputPath, &st) == 0 && st.st_size > 0) {
+		int size;
+		unsigned char *buffer = ReadWholeFile(outputPath, &size);
+
+		WriteWholeFile(tempPath, buffer, size);
+		free(buffer);
+
+		if (rename(tempPath, cachePath) != 0)
+			remove(tempPath);
+
+		// Keys are uniformly spread, so this asks single conversions to
+		// check the cache size after about one new entry in 256.
+		if (strcmp(key + CACHE_KEY_LENGTH - 2, "00") == 0)
+			sPruneDue = true;
+	}
+
+	free(tempPath);
+	free(cachePath);
+}
+
+struct CacheEntry
+{
+	char *path;
+	uint64_t size;
+	time_t lastUsed;
+};
+
+static int CompareCacheEntries(const void *a, const void *b)
+{
+	const struct CacheEntry *entryA = a;
+	const struct CacheEntry *entryB = b;
+
+	return (entryA->lastUsed > entryB->lastUsed) - (entryA->lastUsed < entryB->lastUsed);
+}
+
+static bool IsCacheEntryName(const char *name)
+{
+	if (strlen(name) != CACHE_KEY_LENGTH)
+		return false;
+
+	for (int i = 0; i < CACHE_KEY_LENGTH; i++) {
+		if (!((name[i] >= '0' && name[i] <= '9') || (name[i] >= 'a' && name[i] <= 'f')))
+			return false;
+	}
+
+	return true;
+}
+
+// Removes the least recently used entries once the cache holds more than
+// CACHE_MAX_SIZE, until it is back down to three quarters of that. Unless
+// always is set, the directory is only checked when StoreCachedOutput has
+// asked for it, since listing it costs more than a single conversion.
+void PruneOutputCache(bool always)
+{
+	if (sCacheDir == NULL || (!always && !sPruneDue))
+		return;
+
+	sPruneDue = false;
+
+	DIR *dir = opendir(sCacheDir);
+
+	if (dir == NULL)
+		return;
+
+	struct CacheEntry *entries = NULL;
+	size_t numEntries = 0;
+	size_t capacity = 0;
+	uint64_t totalSize = 0;
+	struct dirent *dirEntry;
+
+	while ((dirEntry = readdir(dir)) != NULL) {
+		if (!IsCacheEntryName(dirEntry->d_name))
+			continue;
+
+		char *path = GetCachePath(dirEntry->d_name);
+		struct stat st;
+
+		if (stat(path, &st) != 0 || !S_ISREG(st.st_mode)) {
+			free(path);
+			continue;
+		}
+
+		if (numEntries == capacity) {
+			capacity = capacity ? capacity * 2 : 256;
+			entries = realloc(entries, sizeof(struct CacheEntry) * capacity);
+
+			if (entries == NULL)
+				FATAL_ERROR("Failed to allocate memory for cache entries.\n");
+		}
+
+		entries[numEntries].path = path;
+		entries[numEntries].size = st.st_size;
+		entries[numEntries].lastUsed = st.st_mtime;
+		numEntries++;
+		totalSize += st.st_size;
+	}
+
+	closedir(dir);
+
+	if (totalSize > CACHE_MAX_SIZE) {
+		qsort(entries, numEntries, sizeof(struct CacheEntry), CompareCacheEntries);
+
+		for (size_t i = 0; i < numEntries && totalSize > CACHE_MAX_SIZE / 4 * 3; i++) {
+			if (remove(entries[i].path) == 0)
+				totalSize -= entries[i].size;
+		}
+	}
+
+	for (size_t i = 0; i < numEntries; i++)
+		free(entries[i].path);
+
+	free(entries);
+}
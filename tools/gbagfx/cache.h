@@ -0,0 +1,15 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdbool.h>
+
+#define CACHE_KEY_LENGTH 16
+
+void InitOutputCache(char *cacheDir, char *programPath);
+bool IsOutputCacheEnabled(void);
+void GetOutputCacheKey(int argc, char **argv, char *outputPath, char *key);
+bool RestoreCachedOutput(char *key, char *outputPath);
+void StoreCachedOutput(char *key, char *outputPath);
+void PruneOutputCache(bool always);
+
+#endif // CACHE_H
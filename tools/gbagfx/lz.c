@@ -69,7 +69,202 @@ fail:
 	FATAL_ERROR("Fatal error while decompressing LZ file.\n");
 }
 
-unsigned char *LZCompress(unsigned char *src, int srcSize, int *compressedSize, const int minDistance)
+#define LZ_MIN_MATCH 3
+#define LZ_MAX_MATCH 18
+#define LZ_MAX_DISTANCE 0x1000
+#define LZ_HASH_BITS 15
+#define LZ_NO_POSITION -1
+
+// Hash chains over the 3-byte prefixes of the input. head[] holds the most
+// recent position with each hash and prev[] links each position to the
+// previous one with the same hash, so walking a chain visits candidates in
+// order of increasing distance.
+struct LZMatchFinder
+{
+	unsigned char *src;
+	int srcSize;
+	int minDistance;
+	int *head;
+	int *prev;
+	int numInserted;
+};
+
+static int LZHash(unsigned char *s)
+{
+	unsigned int value = s[0] | (s[1] << 8) | (s[2] << 16);
+
+	return (value * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+static void LZInitMatchFinder(struct LZMatchFinder *finder, unsigned char *src, int srcSize, int minDistance)
+{
+	finder->src = src;
+	finder->srcSize = srcSize;
+	finder->minDistance = minDistance;
+	finder->head = malloc(sizeof(int) << LZ_HASH_BITS);
+	finder->prev = malloc(sizeof(int) * srcSize);
+	finder->numInserted = 0;
+
+	if (finder->head == NULL || finder->prev == NULL)
+		FATAL_ERROR("Failed to allocate memory for LZ match finder.\n");
+
+	for (int i = 0; i < (1 << LZ_HASH_BITS); i++)
+		finder->head[i] = LZ_NO_POSITION;
+}
+
+static void LZFreeMatchFinder(struct LZMatchFinder *finder)
+{
+	free(finder->head);
+	free(finder->prev);
+}
+
+// Finds the longest match for the data at srcPos, preferring the shortest
+// distance among equally long matches. This gives exactly the same result as
+// trying every distance from minDistance up to 0x1000 in order.
+static int LZFindMatch(struct LZMatchFinder *finder, int srcPos, int *matchDistance)
+{
+	unsigned char *src = finder->src;
+	int bestSize = 0;
+
+	// Every earlier position has to be in the chains before searching.
+	while (finder->numInserted < srcPos) {
+		int pos = finder->numInserted++;
+
+		if (pos + LZ_MIN_MATCH <= finder->srcSize) {
+			int hash = LZHash(&src[pos]);
+			finder->prev[pos] = finder->head[hash];
+			finder->head[hash] = pos;
+		}
+	}
+
+	if (srcPos + LZ_MIN_MATCH > finder->srcSize)
+		return 0;
+
+	int maxSize = finder->srcSize - srcPos;
+
+	if (maxSize > LZ_MAX_MATCH)
+		maxSize = LZ_MAX_MATCH;
+
+	for (int candidate = finder->head[LZHash(&src[srcPos])]; candidate != LZ_NO_POSITION; candidate = finder->prev[candidate]) {
+		int distance = srcPos - candidate;
+
+		if (distance > LZ_MAX_DISTANCE)
+			break;
+
+		if (distance < finder->minDistance)
+			continue;
+
+		int size = 0;
+
+		while (size < maxSize && src[candidate + size] == src[srcPos + size])
+			size++;
+
+		if (size > bestSize) {
+			bestSize = size;
+			*matchDistance = distance;
+
+			if (size == maxSize)
+				break;
+		}
+	}
+
+	return bestSize;
+}
+
+struct LZWriter
+{
+	unsigned char *dest;
+	int destPos;
+	int flagsPos;
+	int numTokens;
+};
+
+// Writes either a literal byte (size 0) or a back reference.
+static void LZWriteToken(struct LZWriter *writer, int size, int distance, unsigned char literal)
+{
+	int bit = writer->numTokens++ % 8;
+
+	if (bit == 0) {
+		writer->flagsPos = writer->destPos++;
+		writer->dest[writer->flagsPos] = 0;
+	}
+
+	if (size >= LZ_MIN_MATCH) {
+		writer->dest[writer->flagsPos] |= (0x80 >> bit);
+		size -= LZ_MIN_MATCH;
+		distance--;
+		writer->dest[writer->destPos++] = (size << 4) | ((unsigned int)distance >> 8);
+		writer->dest[writer->destPos++] = (unsigned char)distance;
+	} else {
+		writer->dest[writer->destPos++] = literal;
+	}
+}
+
+// Greedily takes the longest match at each position.
+static void LZCompressGreedy(struct LZWriter *writer, struct LZMatchFinder *finder)
+{
+	int srcPos = 0;
+
+	while (srcPos < finder->srcSize) {
+		int distance = 0;
+		int size = LZFindMatch(finder, srcPos, &distance);
+
+		if (size >= LZ_MIN_MATCH) {
+			LZWriteToken(writer, size, distance, 0);
+			srcPos += size;
+		} else {
+			LZWriteToken(writer, 0, 0, finder->src[srcPos]);
+			srcPos++;
+		}
+	}
+}
+
+// Chooses the sequence of literals and matches with the smallest encoded size.
+// Costs are in bits: a literal is a flag bit and a byte, a match is a flag bit
+// and two bytes. Any prefix of the longest match at a position is also a
+// match at the same distance, so that match is all that needs to be kept.
+static void LZCompressOptimal(struct LZWriter *writer, struct LZMatchFinder *finder)
+{
+	int srcSize = finder->srcSize;
+	int *matchSize = malloc(sizeof(int) * srcSize);
+	int *matchDistance = malloc(sizeof(int) * srcSize);
+	int *cost = malloc(sizeof(int) * (srcSize + 1));
+	int *choice = malloc(sizeof(int) * srcSize);
+
+	if (matchSize == NULL || matchDistance == NULL || cost == NULL || choice == NULL)
+		FATAL_ERROR("Failed to allocate memory for LZ optimal parse.\n");
+
+	for (int i = 0; i < srcSize; i++)
+		matchSize[i] = LZFindMatch(finder, i, &matchDistance[i]);
+
+	cost[srcSize] = 0;
+
+	for (int i = srcSize - 1; i >= 0; i--) {
+		cost[i] = cost[i + 1] + 9;
+		choice[i] = 1;
+
+		for (int size = LZ_MIN_MATCH; size <= matchSize[i]; size++) {
+			if (cost[i + size] + 17 < cost[i]) {
+				cost[i] = cost[i + size] + 17;
+				choice[i] = size;
+			}
+		}
+	}
+
+	for (int i = 0; i < srcSize; i += choice[i]) {
+		if (choice[i] >= LZ_MIN_MATCH)
+			LZWriteToken(writer, choice[i], matchDistance[i], 0);
+		else
+			LZWriteToken(writer, 0, 0, finder->src[i]);
+	}
+
+	free(matchSize);
+	free(matchDistance);
+	free(cost);
+	free(choice);
+}
+
+unsigned char *LZCompress(unsigned char *src, int srcSize, int *compressedSize, const int minDistance, bool optimal)
 {
 	if (srcSize <= 0)
 		goto fail;
@@ -90,64 +285,31 @@ unsigned char *LZCompress(unsigned char *src, int srcSize, int *compressedSize,
 	dest[2] = (unsigned char)(srcSize >> 8);
 	dest[3] = (unsigned char)(srcSize >> 16);
 
-	int srcPos = 0;
-	int destPos = 4;
-
-	for (;;) {
-		unsigned char *flags = &dest[destPos++];
-		*flags = 0;
-
-		for (int i = 0; i < 8; i++) {
-			int bestBlockDistance = 0;
-			int bestBlockSize = 0;
-			int blockDistance = minDistance;
+	struct LZWriter writer = { dest, 4, 0, 0 };
+	struct LZMatchFinder finder;
 
-			while (blockDistance <= srcPos && blockDistance <= 0x1000) {
-				int blockStart = srcPos - blockDistance;
-				int blockSize = 0;
+	LZInitMatchFinder(&finder, src, srcSize, minDistance);
 
-				while (blockSize < 18
-				    && srcPos + blockSize < srcSize
-				    && src[blockStart + blockSize] == src[srcPos + blockSize])
-					blockSize++;
+	if (optimal)
+		LZCompressOptimal(&writer, &finder);
+	else
+		LZCompressGreedy(&writer, &finder);
 
-				if (blockSize > bestBlockSize) {
-					bestBlockDistance = blockDistance;
-					bestBlockSize = blockSize;
+	LZFreeMatchFinder(&finder);
 
-					if (blockSize == 18)
-						break;
-				}
+	int destPos = writer.destPos;
 
-				blockDistance++;
-			}
+	// Pad to multiple of 4 bytes.
+	int remainder = destPos % 4;
 
-			if (bestBlockSize >= 3) {
-				*flags |= (0x80 >> i);
-				srcPos += bestBlockSize;
-				bestBlockSize -= 3;
-				bestBlockDistance--;
-				dest[destPos++] = (bestBlockSize << 4) | ((unsigned int)bestBlockDistance >> 8);
-				dest[destPos++] = (unsigned char)bestBlockDistance;
-			} else {
-				dest[destPos++] = src[srcPos++];
-			}
-
-			if (srcPos == srcSize) {
-				// Pad to multiple of 4 bytes.
-				int remainder = destPos % 4;
-
-				if (remainder != 0) {
-					for (int i = 0; i < 4 - remainder; i++)
-						dest[destPos++] = 0;
-				}
-
-				*compressedSize = destPos;
-				return dest;
-			}
-		}
+	if (remainder != 0) {
+		for (int i = 0; i < 4 - remainder; i++)
+			dest[destPos++] = 0;
 	}
 
+	*compressedSize = destPos;
+	return dest;
+
 fail:
 	FATAL_ERROR("Fatal error while compressing LZ file.\n");
 }
@@ -3,6 +3,8 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
+#include <pthread.h>
+#include <unistd.h>
 #include "global.h"
 #include "util.h"
 #include "options.h"
@@ -13,6 +15,7 @@
 #include "rl.h"
 #include "font.h"
 #include "huff.h"
+#include "cache.h"
 
 struct CommandHandler
 {
@@ -382,6 +385,7 @@ void HandleLZCompressCommand(char *inputPath, char *outputPath, int argc, char *
 {
     int overflowSize = 0;
     int minDistance = 2; // default, for compatibility with LZ77UnCompVram()
+    bool optimal = false;
 
     for (int i = 3; i < argc; i++)
     {
@@ -413,6 +417,13 @@ void HandleLZCompressCommand(char *inputPath, char *outputPath, int argc, char *
             if (minDistance < 1)
                 FATAL_ERROR("LZ min search distance must be positive.\n");
         }
+        else if (strcmp(option, "-optimal") == 0)
+        {
+            // Finds the smallest encoding instead of greedily taking the
+            // longest match, so the output is not byte-identical to the
+            // default mode.
+            optimal = true;
+        }
         else
         {
             FATAL_ERROR("Unrecognized option \"%s\".\n", option);
@@ -429,7 +440,7 @@ void HandleLZCompressCommand(char *inputPath, char *outputPath, int argc, char *
     unsigned char *buffer = ReadWholeFileZeroPadded(inputPath, &fileSize, overflowSize);
 
     int compressedSize;
-    unsigned char *compressedData = LZCompress(buffer, fileSize + overflowSize, &compressedSize, minDistance);
+    unsigned char *compressedData = LZCompress(buffer, fileSize + overflowSize, &compressedSize, minDistance, optimal);
 
     compressedData[1] = (unsigned char)fileSize;
     compressedData[2] = (unsigned char)(fileSize >> 8);
@@ -542,40 +553,38 @@ void HandleHuffDecompressCommand(char *inputPath, char *outputPath, int argc UNU
     free(uncompressedData);
 }
 
-int main(int argc, char **argv)
+static const struct CommandHandler sCommandHandlers[] =
 {
-    char converted = 0;
-
-    if (argc < 3)
-        FATAL_ERROR("Usage: gbagfx INPUT_PATH OUTPUT_PATH [options...]\n");
-
-    struct CommandHandler handlers[] =
-    {
-        { "1bpp", "png", HandleGbaToPngCommand },
-        { "4bpp", "png", HandleGbaToPngCommand },
-        { "8bpp", "png", HandleGbaToPngCommand },
-        { "png", "1bpp", HandlePngToGbaCommand },
-        { "png", "4bpp", HandlePngToGbaCommand },
-        { "png", "8bpp", HandlePngToGbaCommand },
-        { "png", "gbapal", HandlePngToGbaPaletteCommand },
-        { "png", "pal", HandlePngToJascPaletteCommand },
-        { "gbapal", "pal", HandleGbaToJascPaletteCommand },
-        { "pal", "gbapal", HandleJascToGbaPaletteCommand },
-        { "latfont", "png", HandleLatinFontToPngCommand },
-        { "png", "latfont", HandlePngToLatinFontCommand },
-        { "hwjpnfont", "png", HandleHalfwidthJapaneseFontToPngCommand },
-        { "png", "hwjpnfont", HandlePngToHalfwidthJapaneseFontCommand },
-        { "fwjpnfont", "png", HandleFullwidthJapaneseFontToPngCommand },
-        { "png", "fwjpnfont", HandlePngToFullwidthJapaneseFontCommand },
-        { NULL, "huff", HandleHuffCompressCommand },
-        { NULL, "lz", HandleLZCompressCommand },
-        { "huff", NULL, HandleHuffDecompressCommand },
-        { "lz", NULL, HandleLZDecompressCommand },
-        { NULL, "rl", HandleRLCompressCommand },
-        { "rl", NULL, HandleRLDecompressCommand },
-        { NULL, NULL, NULL }
-    };
+    { "1bpp", "png", HandleGbaToPngCommand },
+    { "4bpp", "png", HandleGbaToPngCommand },
+    { "8bpp", "png", HandleGbaToPngCommand },
+    { "png", "1bpp", HandlePngToGbaCommand },
+    { "png", "4bpp", HandlePngToGbaCommand },
+    { "png", "8bpp", HandlePngToGbaCommand },
+    { "png", "gbapal", HandlePngToGbaPaletteCommand },
+    { "png", "pal", HandlePngToJascPaletteCommand },
+    { "gbapal", "pal", HandleGbaToJascPaletteCommand },
+    { "pal", "gbapal", HandleJascToGbaPaletteCommand },
+    { "latfont", "png", HandleLatinFontToPngCommand },
+    { "png", "latfont", HandlePngToLatinFontCommand },
+    { "hwjpnfont", "png", HandleHalfwidthJapaneseFontToPngCommand },
+    { "png", "hwjpnfont", HandlePngToHalfwidthJapaneseFontCommand },
+    { "fwjpnfont", "png", HandleFullwidthJapaneseFontToPngCommand },
+    { "png", "fwjpnfont", HandlePngToFullwidthJapaneseFontCommand },
+    { NULL, "huff", HandleHuffCompressCommand },
+    { NULL, "lz", HandleLZCompressCommand },
+    { "huff", NULL, HandleHuffDecompressCommand },
+    { "lz", NULL, HandleLZDecompressCommand },
+    { NULL, "rl", HandleRLCompressCommand },
+    { "rl", NULL, HandleRLDecompressCommand },
+    { NULL, NULL, NULL }
+};
 
+// Runs a single conversion. argv has the same layout as the command line:
+// argv[1] is the input path, argv[2] the output path, and the rest are options.
+static void ConvertFile(int argc, char **argv)
+{
+    char converted = 0;
     char *inputPath = argv[1];
     char *outputPath = argv[2];
     char *inputFileExtension = GetFileExtensionAfterDot(inputPath);
@@ -612,14 +621,24 @@ int main(int argc, char **argv)
         }
     }
 
-    for (int i = 0; handlers[i].function != NULL; i++)
+    char cacheKey[CACHE_KEY_LENGTH + 1];
+
+    if (IsOutputCacheEnabled())
+    {
+        GetOutputCacheKey(argc, argv, outputPath, cacheKey);
+        converted = RestoreCachedOutput(cacheKey, outputPath);
+    }
+
+    for (int i = 0; !converted && sCommandHandlers[i].function != NULL; i++)
     {
-        if ((handlers[i].inputFileExtension == NULL || strcmp(handlers[i].inputFileExtension, inputFileExtension) == 0)
-            && (handlers[i].outputFileExtension == NULL || strcmp(handlers[i].outputFileExtension, outputFileExtension) == 0))
+        if ((sCommandHandlers[i].inputFileExtension == NULL || strcmp(sCommandHandlers[i].inputFileExtension, inputFileExtension) == 0)
+            && (sCommandHandlers[i].outputFileExtension == NULL || strcmp(sCommandHandlers[i].outputFileExtension, outputFileExtension) == 0))
         {
-            handlers[i].function(inputPath, outputPath, argc, argv);
+            sCommandHandlers[i].function(inputPath, outputPath, argc, argv);
             converted = 1;
-            break;
+
+            if (IsOutputCacheEnabled())
+                StoreCachedOutput(cacheKey, outputPath);
         }
     }
 
@@ -628,6 +647,241 @@ int main(int argc, char **argv)
 
     if (!converted)
         FATAL_ERROR("Don't know how to convert \"%s\" to \"%s\".\n", argv[1], argv[2]);
+}
+
+struct BatchJob
+{
+    int argc;
+    char **argv;
+};
+
+struct BatchQueue
+{
+    struct BatchJob *jobs;
+    int numJobs;
+    int nextJob;
+    pthread_mutex_t mutex;
+};
+
+// Splits a list file line into whitespace-separated arguments, in place.
+// argv[0] is left for the program name so the handlers see the usual layout.
+static bool ParseBatchLine(char *line, char *programPath, struct BatchJob *job)
+{
+    int capacity = 8;
+
+    job->argc = 1;
+    job->argv = malloc(sizeof(char *) * capacity);
+
+    if (job->argv == NULL)
+        FATAL_ERROR("Failed to allocate memory for batch job.\n");
+
+    job->argv[0] = programPath;
+
+    char *p = line;
+
+    for (;;)
+    {
+        while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
+            p++;
+
+        if (*p == 0 || *p == '#')
+            break;
+
+        if (job->argc + 1 >= capacity)
+        {
+            capacity *= 2;
+            job->argv = realloc(job->argv, sizeof(char *) * capacity);
+
+            if (job->argv == NULL)
+                FATAL_ERROR("Failed to allocate memory for batch job.\n");
+        }
+
+        job->argv[job->argc++] = p;
+
+        while (*p != 0 && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n')
+            p++;
+
+        if (*p != 0)
+            *p++ = 0;
+    }
+
+    job->argv[job->argc] = NULL;
+
+    if (job->argc == 1)
+    {
+        free(job->argv);
+        return false;
+    }
+
+    if (job->argc < 3)
+        FATAL_ERROR("Batch line \"%s\" has no output path.\n", job->argv[1]);
+
+    return true;
+}
+
+static void *BatchWorker(void *arg)
+{
+    struct BatchQueue *queue = arg;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&queue->mutex);
+        int jobIndex = queue->nextJob++;
+        pthread_mutex_unlock(&queue->mutex);
+
+        if (jobIndex >= queue->numJobs)
+            break;
+
+        ConvertFile(queue->jobs[jobIndex].argc, queue->jobs[jobIndex].argv);
+    }
+
+    return NULL;
+}
+
+static int GetDefaultThreadCount(void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (count > 0)
+        return count;
+#endif
+    return 4;
+}
+
+// Runs every conversion in a list file, one "INPUT_PATH OUTPUT_PATH [options...]"
+// per line, on a pool of threads. Blank lines and lines starting with '#' are
+// ignored. Any failing conversion ends the whole batch.
+static void ConvertBatch(int argc, char **argv)
+{
+    char *listPath = argv[2];
+    int numThreads = GetDefaultThreadCount();
+
+    for (int i = 3; i < argc; i++)
+    {
+        char *option = argv[i];
+
+        if (strcmp(option, "-j") == 0)
+        {
+            if (i + 1 >= argc)
+                FATAL_ERROR("No thread count following \"-j\".\n");
+
+            i++;
+
+            if (!ParseNumber(argv[i], NULL, 10, &numThreads))
+                FATAL_ERROR("Failed to parse thread count.\n");
+
+            if (numThreads < 1)
+                FATAL_ERROR("Thread count must be positive.\n");
+        }
+        else
+        {
+            FATAL_ERROR("Unrecognized option \"%s\".\n", option);
+        }
+    }
+
+    int fileSize;
+    char *list = (char *)ReadWholeFileZeroPadded(listPath, &fileSize, 1);
+
+    struct BatchQueue queue;
+    int capacity = 64;
+
+    queue.jobs = malloc(sizeof(struct BatchJob) * capacity);
+    queue.numJobs = 0;
+    queue.nextJob = 0;
+
+    if (queue.jobs == NULL)
+        FATAL_ERROR("Failed to allocate memory for batch jobs.\n");
+
+    char *line = list;
+
+    while (*line != 0)
+    {
+        char *end = strchr(line, '\n');
+        char *next = end != NULL ? end + 1 : line + strlen(line);
+
+        if (end != NULL)
+            *end = 0;
+
+        if (queue.numJobs == capacity)
+        {
+            capacity *= 2;
+            queue.jobs = realloc(queue.jobs, sizeof(struct BatchJob) * capacity);
+
+            if (queue.jobs == NULL)
+                FATAL_ERROR("Failed to allocate memory for batch jobs.\n");
+        }
+
+        if (ParseBatchLine(line, argv[0], &queue.jobs[queue.numJobs]))
+            queue.numJobs++;
+
+        line = next;
+    }
+
+    if (numThreads > queue.numJobs)
+        numThreads = queue.numJobs;
+
+    pthread_mutex_init(&queue.mutex, NULL);
+
+    if (numThreads <= 1)
+    {
+        BatchWorker(&queue);
+    }
+    else
+    {
+        pthread_t *threads = malloc(sizeof(pthread_t) * numThreads);
+
+        if (threads == NULL)
+            FATAL_ERROR("Failed to allocate memory for batch threads.\n");
+
+        for (int i = 0; i < numThreads; i++)
+            if (pthread_create(&threads[i], NULL, BatchWorker, &queue) != 0)
+                FATAL_ERROR("Failed to create batch thread.\n");
+
+        for (int i = 0; i < numThreads; i++)
+            pthread_join(threads[i], NULL);
+
+        free(threads);
+    }
+
+    pthread_mutex_destroy(&queue.mutex);
+
+    for (int i = 0; i < queue.numJobs; i++)
+        free(queue.jobs[i].argv);
+
+    free(queue.jobs);
+    free(list);
+}
+
+int main(int argc, char **argv)
+{
+    // Options before the paths apply to every conversion.
+    // "-cache DIR" reuses earlier outputs for identical inputs and options.
+    while (argc > 1 && strcmp(argv[1], "-cache") == 0)
+    {
+        if (argc < 3)
+            FATAL_ERROR("No directory following \"-cache\".\n");
+
+        InitOutputCache(argv[2], argv[0]);
+        argv[2] = argv[0];
+        argc -= 2;
+        argv += 2;
+    }
+
+    if (argc < 3)
+        FATAL_ERROR("Usage: gbagfx [-cache DIR] INPUT_PATH OUTPUT_PATH [options...]\n"
+                    "       gbagfx [-cache DIR] batch LIST_FILE [-j THREADS]\n");
+
+    if (strcmp(argv[1], "batch") == 0)
+    {
+        ConvertBatch(argc, argv);
+        PruneOutputCache(true);
+    }
+    else
+    {
+        ConvertFile(argc, argv);
+        PruneOutputCache(false);
+    }
 
     return 0;
 }
@@ -109,7 +109,7 @@ unsigned char *ReadWholeFileZeroPadded(char *path, int *size, int padAmount)
 
 	rewind(fp);
 
-	if (fread(buffer, *size, 1, fp) != 1)
+	if (*size > 0 && fread(buffer, *size, 1, fp) != 1)
 		FATAL_ERROR("Failed to read \"%s\".\n", path);
 
 	fclose(fp);
@@ -10,6 +10,9 @@ using std::string; using std::to_string;
 #include <algorithm>
 using std::replace_if;
 
+#include <fstream>
+#include <sstream>
+
 #include <inja.hpp>
 using namespace inja;
 using json = nlohmann::json;
@@ -26,21 +29,19 @@ string get_custom_var(string key)
     return customVars[key];
 }
 
-int main(int argc, char *argv[])
+struct Job
 {
-    if (argc != 4)
-        FATAL_ERROR("USAGE: jsonproc <json-filepath> <template-filepath> <output-filepath>\n");
-
-    string jsonfilepath = argv[1];
-    string templateFilepath = argv[2];
-    string outputFilepath = argv[3];
-
-    Environment env;
-    env.set_trim_blocks(true);
+    string jsonFilepath;
+    string templateFilepath;
+    string outputFilepath;
+};
 
+// The callbacks read the paths of the job being rendered from `job`.
+void add_callbacks(Environment& env, const Job& job)
+{
     // Add custom command callbacks.
-    env.add_callback("doNotModifyHeader", 0, [jsonfilepath, templateFilepath](Arguments& args) {
-        return "//\n// DO NOT MODIFY THIS FILE! It is auto-generated from " + jsonfilepath +" and Inja template " + templateFilepath + "\n//\n";
+    env.add_callback("doNotModifyHeader", 0, [&job](Arguments& args) {
+        return "//\n// DO NOT MODIFY THIS FILE! It is auto-generated from " + job.jsonFilepath +" and Inja template " + job.templateFilepath + "\n//\n";
     });
 
     env.add_callback("subtract", 2, [](Arguments& args) {
@@ -114,10 +115,107 @@ int main(int argc, char *argv[])
         }
         return str;
     });
+}
+
+// Only replace the output when its contents change, so that anything built
+// from it isn't rebuilt when the JSON is touched without affecting it.
+void write_if_changed(const string& filepath, const string& text)
+{
+    std::ifstream in(filepath);
+
+    if (in.is_open())
+    {
+        std::stringstream existing;
+        existing << in.rdbuf();
+
+        if (existing.str() == text)
+            return;
+
+        in.close();
+    }
+
+    std::ofstream out(filepath);
+
+    if (!out.is_open())
+        FATAL_ERROR("JSONPROC_ERROR: failed writing file at '%s'\n", filepath.c_str());
+
+    out << text;
+}
+
+// Renders every job in the manifest with one environment. Each line of the
+// manifest is "<json-filepath> <template-filepath> <output-filepath>".
+// Templates and JSON documents used by several jobs are only parsed once.
+void process_manifest(const string& manifestFilepath)
+{
+    std::ifstream manifest(manifestFilepath);
+
+    if (!manifest.is_open())
+        FATAL_ERROR("JSONPROC_ERROR: failed accessing file at '%s'\n", manifestFilepath.c_str());
+
+    Job job;
+    Environment env;
+    env.set_trim_blocks(true);
+    add_callbacks(env, job);
+
+    std::map<string, Template> templates;
+    std::map<string, json> documents;
+    string line;
+
+    while (std::getline(manifest, line))
+    {
+        std::istringstream fields(line);
+
+        if (!(fields >> job.jsonFilepath))
+            continue;
+
+        if (!(fields >> job.templateFilepath >> job.outputFilepath))
+            FATAL_ERROR("JSONPROC_ERROR: malformed manifest line '%s'\n", line.c_str());
+
+        try
+        {
+            auto tmpl = templates.find(job.templateFilepath);
+            if (tmpl == templates.end())
+                tmpl = templates.emplace(job.templateFilepath, env.parse_template(job.templateFilepath)).first;
+
+            auto document = documents.find(job.jsonFilepath);
+            if (document == documents.end())
+                document = documents.emplace(job.jsonFilepath, env.load_json(job.jsonFilepath)).first;
+
+            // Variables set by one template must not leak into the next job.
+            customVars.clear();
+            write_if_changed(job.outputFilepath, env.render(tmpl->second, document->second));
+        }
+        catch (const std::exception& e)
+        {
+            FATAL_ERROR("JSONPROC_ERROR: %s\n", e.what());
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc == 3 && string(argv[1]) == "-m")
+    {
+        process_manifest(argv[2]);
+        return 0;
+    }
+
+    if (argc != 4)
+        FATAL_ERROR("USAGE: jsonproc <json-filepath> <template-filepath> <output-filepath>\n"
+                    "       jsonproc -m <manifest-filepath>\n");
+
+    Job job;
+    job.jsonFilepath = argv[1];
+    job.templateFilepath = argv[2];
+    job.outputFilepath = argv[3];
+
+    Environment env;
+    env.set_trim_blocks(true);
+    add_callbacks(env, job);
 
     try
     {
-        env.write_with_json_file(templateFilepath, jsonfilepath, outputFilepath);
+        write_if_changed(job.outputFilepath, env.render_file_with_json_file(job.templateFilepath, job.jsonFilepath));
     }
     catch (const std::exception& e)
     {
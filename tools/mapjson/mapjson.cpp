@@ -10,7 +10,7 @@ using std::string;
 using std::vector;
 
 #include <algorithm>
-using std::sort; using std::find;
+using std::sort; using std::find; using std::max;
 
 #include <map>
 using std::map;
@@ -24,6 +24,15 @@ using std::ostringstream;
 #include <limits>
 using std::numeric_limits;
 
+#include <atomic>
+using std::atomic;
+
+#include <thread>
+using std::thread;
+
+#include <set>
+using std::set;
+
 #include "json11.h"
 using json11::Json;
 
@@ -60,7 +69,26 @@ void write_text_file(string filepath, string text) {
     out_file.close();
 }
 
-string generate_map_header_text(Json map_data, Json layouts_data, string version) {
+// Like write_text_file, but leaves the file (and its timestamp) alone if it
+// already has the same contents, so make doesn't rebuild anything that uses it.
+void update_text_file(string filepath, string text) {
+    ifstream in_file(filepath, std::ifstream::binary);
+
+    if (in_file.is_open()) {
+        ostringstream old_text;
+        old_text << in_file.rdbuf();
+        in_file.close();
+
+        if (old_text.str() == text)
+            return;
+    }
+
+    write_text_file(filepath, text);
+}
+
+typedef void (*text_file_writer)(string, string);
+
+Json get_map_layout(Json map_data, Json layouts_data) {
     string map_layout_id = map_data["layout"].string_value();
 
     vector<Json> matched;
@@ -73,8 +101,10 @@ string generate_map_header_text(Json map_data, Json layouts_data, string version
     if (matched.size() != 1)
         FATAL_ERROR("Failed to find matching layout for %s.\n", map_layout_id.c_str());
 
-    Json layout = matched[0];
+    return matched[0];
+}
 
+string generate_map_header_text(Json map_data, Json layout, string version) {
     ostringstream text;
 
     text << "@\n@ DO NOT MODIFY THIS FILE! It is auto-generated from data/maps/"
@@ -285,7 +315,7 @@ void process_map(string map_filepath, string layouts_filepath, string version) {
     if (layouts_data == Json())
         FATAL_ERROR("%s\n", layouts_err.c_str());
 
-    string header_text = generate_map_header_text(map_data, layouts_data, version);
+    string header_text = generate_map_header_text(map_data, get_map_layout(map_data, layouts_data), version);
     string events_text = generate_map_events_text(map_data);
     string connections_text = generate_map_connections_text(map_data);
 
@@ -381,10 +411,16 @@ string generate_events_text(Json groups_data) {
     return text.str();
 }
 
-string generate_map_constants_text(string groups_filepath, Json groups_data) {
+string get_map_filepath(string groups_filepath, string map_name) {
     string file_dir = get_directory_name(groups_filepath);
     char dir_separator = file_dir.back();
 
+    return file_dir + map_name + dir_separator + "map.json";
+}
+
+string generate_map_constants_text(string groups_filepath, Json groups_data, const map<string, Json> &maps_data, text_file_writer write_file) {
+    string file_dir = get_directory_name(groups_filepath);
+
     ostringstream text;
     ostringstream mapCountText;
 
@@ -394,6 +430,7 @@ string generate_map_constants_text(string groups_filepath, Json groups_data) {
     text << "//\n// DO NOT MODIFY THIS FILE! It is auto-generated from data/maps/map_groups.json\n//\n\n";
 
     int group_num = 0;
+    int max_map_count = 0;
     vector<int> map_count_vec; //DEBUG
 
     for (auto &group : groups_data["group_order"].array_items()) {
@@ -404,9 +441,14 @@ string generate_map_constants_text(string groups_filepath, Json groups_data) {
         int map_count = 0; //DEBUG
 
         for (auto &map_name : groups_data[group.string_value()].array_items()) {
-            string header_filepath = file_dir + map_name.string_value() + dir_separator + "map.json";
-            string err_str;
-            Json map_data = Json::parse(read_text_file(header_filepath), err_str);
+            Json map_data;
+            auto it = maps_data.find(map_name.string_value());
+            if (it != maps_data.end()) {
+                map_data = it->second;
+            } else {
+                string err_str;
+                map_data = Json::parse(read_text_file(get_map_filepath(groups_filepath, map_name.string_value())), err_str);
+            }
             map_ids.push_back(map_data["id"]);
             if (map_data["id"].string_value().length() > max_length)
                 max_length = map_data["id"].string_value().length();
@@ -421,10 +463,12 @@ string generate_map_constants_text(string groups_filepath, Json groups_data) {
         text << "\n";
 
         group_num++;
+        max_map_count = max(max_map_count, map_count);
         map_count_vec.push_back(map_count); //DEBUG
     }
 
-    text << "#define MAP_GROUPS_COUNT " << group_num << "\n\n";
+    text << "#define MAP_GROUPS_COUNT " << group_num << "\n";
+    text << "#define MAX_MAPS_IN_GROUP " << max_map_count << "\n\n";
     text << "#endif // GUARD_CONSTANTS_MAP_GROUPS_H\n";
 
     char s = file_dir.back();
@@ -433,32 +477,36 @@ string generate_map_constants_text(string groups_filepath, Json groups_data) {
         mapCountText << map_count_vec[i] << ", ";            //DEBUG
     }                                                        //DEBUG
     mapCountText << "0};\n";                                 //DEBUG
-    write_text_file(file_dir + ".." + s + ".." + s + "src" + s + "data" + s + "map_group_count.h", mapCountText.str());
+    write_file(file_dir + ".." + s + ".." + s + "src" + s + "data" + s + "map_group_count.h", mapCountText.str());
 
     return text.str();
 }
 
-void process_groups(string groups_filepath) {
-    string err;
-    Json groups_data = Json::parse(read_text_file(groups_filepath), err);
-
-    if (groups_data == Json())
-        FATAL_ERROR("%s\n", err.c_str());
-
+void write_groups_files(string groups_filepath, Json groups_data, const map<string, Json> &maps_data, text_file_writer write_file) {
     string groups_text = generate_groups_text(groups_data);
     string connections_text = generate_connections_text(groups_data);
     string headers_text = generate_headers_text(groups_data);
     string events_text = generate_events_text(groups_data);
-    string map_header_text = generate_map_constants_text(groups_filepath, groups_data);
+    string map_header_text = generate_map_constants_text(groups_filepath, groups_data, maps_data, write_file);
 
     string file_dir = get_directory_name(groups_filepath);
     char s = file_dir.back();
 
-    write_text_file(file_dir + "groups.inc", groups_text);
-    write_text_file(file_dir + "connections.inc", connections_text);
-    write_text_file(file_dir + "headers.inc", headers_text);
-    write_text_file(file_dir + "events.inc", events_text);
-    write_text_file(file_dir + ".." + s + ".." + s + "include" + s + "constants" + s + "map_groups.h", map_header_text);
+    write_file(file_dir + "groups.inc", groups_text);
+    write_file(file_dir + "connections.inc", connections_text);
+    write_file(file_dir + "headers.inc", headers_text);
+    write_file(file_dir + "events.inc", events_text);
+    write_file(file_dir + ".." + s + ".." + s + "include" + s + "constants" + s + "map_groups.h", map_header_text);
+}
+
+void process_groups(string groups_filepath) {
+    string err;
+    Json groups_data = Json::parse(read_text_file(groups_filepath), err);
+
+    if (groups_data == Json())
+        FATAL_ERROR("%s\n", err.c_str());
+
+    write_groups_files(groups_filepath, groups_data, map<string, Json>(), write_text_file);
 }
 
 string generate_layout_headers_text(Json layouts_data) {
@@ -517,6 +565,19 @@ string generate_layouts_constants_text(Json layouts_data) {
     return text.str();
 }
 
+void write_layouts_files(string layouts_filepath, Json layouts_data, text_file_writer write_file) {
+    string layout_headers_text = generate_layout_headers_text(layouts_data);
+    string layouts_table_text = generate_layouts_table_text(layouts_data);
+    string layouts_constants_text = generate_layouts_constants_text(layouts_data);
+
+    string file_dir = get_directory_name(layouts_filepath);
+    char s = file_dir.back();
+
+    write_file(file_dir + "layouts.inc", layout_headers_text);
+    write_file(file_dir + "layouts_table.inc", layouts_table_text);
+    write_file(file_dir + ".." + s + ".." + s + "include" + s + "constants" + s + "layouts.h", layouts_constants_text);
+}
+
 void process_layouts(string layouts_filepath) {
     string err;
     Json layouts_data = Json::parse(read_text_file(layouts_filepath), err);
@@ -524,16 +585,119 @@ void process_layouts(string layouts_filepath) {
     if (layouts_data == Json())
         FATAL_ERROR("%s\n", err.c_str());
 
-    string layout_headers_text = generate_layout_headers_text(layouts_data);
-    string layouts_table_text = generate_layouts_table_text(layouts_data);
-    string layouts_constants_text = generate_layouts_constants_text(layouts_data);
+    write_layouts_files(layouts_filepath, layouts_data, write_text_file);
+}
 
-    string file_dir = get_directory_name(layouts_filepath);
-    char s = file_dir.back();
+// Escapes spaces for a make rule.
+string escape_make_path(string path) {
+    string escaped;
+
+    for (char c : path) {
+        if (c == ' ')
+            escaped += '\\';
+        escaped += c;
+    }
+
+    return escaped;
+}
+
+void write_depfile(string depfile_filepath, string target, const vector<string> &inputs) {
+    ostringstream text;
+
+    text << escape_make_path(target) << ":";
+    for (const string &input : inputs)
+        text << " \\\n\t" << escape_make_path(input);
+    text << "\n";
 
-    write_text_file(file_dir + "layouts.inc", layout_headers_text);
-    write_text_file(file_dir + "layouts_table.inc", layouts_table_text);
-    write_text_file(file_dir + ".." + s + ".." + s + "include" + s + "constants" + s + "layouts.h", layouts_constants_text);
+    // Empty rules so deleting a map doesn't make the depfile itself an error.
+    for (const string &input : inputs)
+        text << "\n" << escape_make_path(input) << ":\n";
+
+    update_text_file(depfile_filepath, text.str());
+}
+
+// Does the work of every "layouts", "groups" and "map" invocation at once,
+// parsing layouts.json and map_groups.json a single time and processing the
+// maps on all available cores. Files are only rewritten if their contents
+// change. Since that leaves their timestamps alone, the stamp file is touched
+// instead, and a depfile listing every input is written next to it.
+void process_all(string groups_filepath, string layouts_filepath, string stamp_filepath, string version) {
+    string groups_err, layouts_err;
+
+    Json groups_data = Json::parse(read_text_file(groups_filepath), groups_err);
+    if (groups_data == Json())
+        FATAL_ERROR("%s\n", groups_err.c_str());
+
+    Json layouts_data = Json::parse(read_text_file(layouts_filepath), layouts_err);
+    if (layouts_data == Json())
+        FATAL_ERROR("%s\n", layouts_err.c_str());
+
+    map<string, Json> layouts_by_id;
+    set<string> duplicate_layout_ids;
+
+    for (auto &layout : layouts_data["layouts"].array_items()) {
+        string id = layout["id"].string_value();
+        if (!layouts_by_id.insert({id, layout}).second)
+            duplicate_layout_ids.insert(id);
+    }
+
+    vector<string> map_names;
+
+    for (auto &group : groups_data["group_order"].array_items())
+    for (auto &map_name : groups_data[group.string_value()].array_items())
+        map_names.push_back(map_name.string_value());
+
+    vector<Json> maps(map_names.size());
+    atomic<size_t> next_map(0);
+
+    auto worker = [&]() {
+        size_t i;
+
+        while ((i = next_map++) < map_names.size()) {
+            string map_filepath = get_map_filepath(groups_filepath, map_names[i]);
+            string err;
+
+            Json map_data = Json::parse(read_text_file(map_filepath), err);
+            if (map_data == Json())
+                FATAL_ERROR("%s\n", err.c_str());
+
+            string layout_id = map_data["layout"].string_value();
+            auto layout = layouts_by_id.find(layout_id);
+            if (layout == layouts_by_id.end() || duplicate_layout_ids.count(layout_id) != 0)
+                FATAL_ERROR("Failed to find matching layout for %s.\n", layout_id.c_str());
+
+            string files_dir = get_directory_name(map_filepath);
+            update_text_file(files_dir + "header.inc", generate_map_header_text(map_data, layout->second, version));
+            update_text_file(files_dir + "events.inc", generate_map_events_text(map_data));
+            update_text_file(files_dir + "connections.inc", generate_map_connections_text(map_data));
+
+            maps[i] = map_data;
+        }
+    };
+
+    unsigned num_threads = thread::hardware_concurrency();
+    if (num_threads == 0)
+        num_threads = 1;
+
+    vector<thread> threads;
+    for (unsigned i = 0; i < num_threads; i++)
+        threads.emplace_back(worker);
+    for (thread &t : threads)
+        t.join();
+
+    map<string, Json> maps_data;
+    vector<string> inputs = { groups_filepath, layouts_filepath };
+
+    for (size_t i = 0; i < map_names.size(); i++) {
+        maps_data[map_names[i]] = maps[i];
+        inputs.push_back(get_map_filepath(groups_filepath, map_names[i]));
+    }
+
+    write_groups_files(groups_filepath, groups_data, maps_data, update_text_file);
+    write_layouts_files(layouts_filepath, layouts_data, update_text_file);
+
+    write_depfile(stamp_filepath + ".d", stamp_filepath, inputs);
+    write_text_file(stamp_filepath, "");
 }
 
 int main(int argc, char *argv[]) {
@@ -547,8 +711,8 @@ int main(int argc, char *argv[]) {
 
     char *mode_arg = argv[1];
     string mode(mode_arg);
-    if (mode != "layouts" && mode != "map" && mode != "groups")
-        FATAL_ERROR("ERROR: <mode> must be 'layouts', 'map', or 'groups'.\n");
+    if (mode != "layouts" && mode != "map" && mode != "groups" && mode != "all")
+        FATAL_ERROR("ERROR: <mode> must be 'layouts', 'map', 'groups', or 'all'.\n");
 
     if (mode == "map") {
         if (argc != 5)
@@ -575,6 +739,16 @@ int main(int argc, char *argv[]) {
 
         process_layouts(filepath);
     }
+    else if (mode == "all") {
+        if (argc != 6)
+            FATAL_ERROR("USAGE: mapjson all <game-version> <groups_file> <layouts_file> <stamp_file>\n");
+
+        string groups_filepath(argv[3]);
+        string layouts_filepath(argv[4]);
+        string stamp_filepath(argv[5]);
+
+        process_all(groups_filepath, layouts_filepath, stamp_filepath, version);
+    }
 
     return 0;
 }
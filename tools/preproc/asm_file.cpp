@@ -507,7 +507,8 @@ void AsmFile::OutputLine()
         if (m_pos >= m_size)
         {
             RaiseWarning("file doesn't end with newline");
-            puts(&m_buffer[m_lineStart]);
+            g_output.Write(&m_buffer[m_lineStart], m_pos - m_lineStart);
+            g_output.Put('\n');
         }
         else
         {
@@ -516,10 +517,8 @@ void AsmFile::OutputLine()
     }
     else
     {
-        m_buffer[m_pos] = 0;
-        puts(&m_buffer[m_lineStart]);
-        m_buffer[m_pos] = '\n';
         m_pos++;
+        g_output.Write(&m_buffer[m_lineStart], m_pos - m_lineStart);
         m_lineStart = m_pos;
         m_lineNum++;
     }
@@ -564,7 +563,7 @@ bool AsmFile::IsAtEnd()
 // Output the current location to set gas's logical file and line numbers.
 void AsmFile::OutputLocation()
 {
-    std::printf("# %ld \"%s\"\n", m_lineNum, m_filename.c_str());
+    g_output.Print("# %ld \"%s\"\n", m_lineNum, m_filename.c_str());
 }
 
 // Reports a diagnostic message.
@@ -108,30 +108,54 @@ void CFile::Preproc()
 
     while (m_pos < m_size)
     {
+        // Most of the input is passed through unchanged, so copy whole spans
+        // at once and only stop at characters that can change the state.
+        long spanStart = m_pos;
+
         if (stringChar)
         {
-            if (m_buffer[m_pos] == stringChar)
+            while (m_pos < m_size && m_buffer[m_pos] != stringChar)
             {
-                std::putchar(stringChar);
-                m_pos++;
-                stringChar = 0;
-            }
-            else if (m_buffer[m_pos] == '\\' && m_buffer[m_pos + 1] == stringChar)
-            {
-                std::putchar('\\');
-                std::putchar(stringChar);
-                m_pos += 2;
+                if (m_buffer[m_pos] == '\\' && m_buffer[m_pos + 1] == stringChar)
+                {
+                    m_pos += 2;
+                }
+                else
+                {
+                    if (m_buffer[m_pos] == '\n')
+                        m_lineNum++;
+                    m_pos++;
+                }
             }
-            else
+
+            g_output.Write(&m_buffer[spanStart], m_pos - spanStart);
+
+            if (m_pos < m_size)
             {
-                if (m_buffer[m_pos] == '\n')
-                    m_lineNum++;
-                std::putchar(m_buffer[m_pos]);
+                g_output.Put(stringChar);
                 m_pos++;
+                stringChar = 0;
             }
         }
         else
         {
+            // Strings and incbins can only start at '_' and 'I'.
+            while (m_pos < m_size)
+            {
+                char c = m_buffer[m_pos];
+
+                if (c == '_' || c == 'I' || c == '"' || c == '\'')
+                    break;
+                if (c == '\n')
+                    m_lineNum++;
+                m_pos++;
+            }
+
+            g_output.Write(&m_buffer[spanStart], m_pos - spanStart);
+
+            if (m_pos >= m_size)
+                break;
+
             TryConvertString();
             TryConvertIncbin();
 
@@ -140,7 +164,7 @@ void CFile::Preproc()
 
             char c = m_buffer[m_pos++];
 
-            std::putchar(c);
+            g_output.Put(c);
 
             if (c == '\n')
                 m_lineNum++;
@@ -169,7 +193,7 @@ bool CFile::ConsumeNewline()
     {
         m_pos += 2;
         m_lineNum++;
-        std::putchar('\n');
+        g_output.Put('\n');
         return true;
     }
 
@@ -177,7 +201,7 @@ bool CFile::ConsumeNewline()
     {
         m_pos++;
         m_lineNum++;
-        std::putchar('\n');
+        g_output.Put('\n');
         return true;
     }
 
@@ -220,7 +244,7 @@ void CFile::TryConvertString()
 
     SkipWhitespace();
 
-    std::printf("{ ");
+    g_output.Write("{ ", 2);
 
     while (1)
     {
@@ -242,7 +266,10 @@ void CFile::TryConvertString()
             }
 
             for (int i = 0; i < length; i++)
-                printf("0x%02X, ", s[i]);
+            {
+                g_output.PutHexByte(s[i]);
+                g_output.Write(", ", 2);
+            }
         }
         else if (m_buffer[m_pos] == ')')
         {
@@ -261,9 +288,9 @@ void CFile::TryConvertString()
     }
 
     if (noTerminator)
-        std::printf(" }");
+        g_output.Write(" }", 2);
     else
-        std::printf("0xFF }");
+        g_output.Write("0xFF }", 6);
 }
 
 bool CFile::CheckIdentifier(const std::string& ident)
@@ -355,7 +382,7 @@ void CFile::TryConvertIncbin()
 
     m_pos++;
 
-    std::printf("{");
+    g_output.Put('{');
 
     while (true)
     {
@@ -406,9 +433,15 @@ void CFile::TryConvertIncbin()
             offset += size;
 
             if (isSigned)
-                std::printf("%d,", data);
+            {
+                g_output.PutSigned(data);
+                g_output.Put(',');
+            }
             else
-                std::printf("%uu,", data);
+            {
+                g_output.PutUnsigned(data);
+                g_output.Write("u,", 2);
+            }
         }
 
         SkipWhitespace();
@@ -424,7 +457,7 @@ void CFile::TryConvertIncbin()
 
     m_pos++;
 
-    std::printf("}");
+    g_output.Put('}');
 }
 
 // Reports a diagnostic message.
@@ -18,9 +18,11 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdint>
 #include <cstdarg>
+#include <cstring>
 #include "preproc.h"
 #include "charmap.h"
 #include "char_util.h"
@@ -369,40 +371,186 @@ void CharmapReader::SkipWhitespace()
         m_pos++;
 }
 
-Charmap::Charmap(std::string filename)
+static CharmapSequence MakeSequence(const std::string& bytes)
+{
+    CharmapSequence sequence = {};
+
+    sequence.length = static_cast<unsigned char>(bytes.length());
+    for (std::size_t i = 0; i < bytes.length(); i++)
+        sequence.bytes[i] = bytes[i];
+
+    return sequence;
+}
+
+static std::uint32_t HashConstantName(const char* name, std::size_t length, std::uint32_t seed)
+{
+    std::uint32_t hash = 2166136261u ^ (seed * 0x9E3779B9u);
+
+    for (std::size_t i = 0; i < length; i++)
+    {
+        hash ^= static_cast<unsigned char>(name[i]);
+        hash *= 16777619u;
+    }
+
+    hash ^= hash >> 15;
+    hash *= 0x2C1B3C6Du;
+    hash ^= hash >> 12;
+
+    return hash;
+}
+
+static std::size_t RoundUpToPowerOfTwo(std::size_t n)
+{
+    std::size_t result = 1;
+
+    while (result < n)
+        result <<= 1;
+
+    return result;
+}
+
+Charmap::Charmap(std::string filename) : m_charIndices(kNumBmpCodes, 0), m_charSequences(1), m_escapes()
 {
     CharmapReader reader(filename);
+    std::map<std::string, CharmapSequence> constants;
 
     for (;;)
     {
         Lhs lhs = reader.ReadLhs();
 
         if (lhs.type == LhsType::None)
-            return;
+            break;
 
         reader.ExpectEqualsSign();
 
-        std::string sequence = reader.ReadSequence();
+        CharmapSequence sequence = MakeSequence(reader.ReadSequence());
 
         switch (lhs.type)
         {
         case LhsType::Char:
-            if (m_chars.find(lhs.code) != m_chars.end())
+            if (Char(lhs.code) != nullptr)
                 reader.RaiseError("redefining char");
-            m_chars[lhs.code] = sequence;
+            AddChar(lhs.code, sequence);
             break;
         case LhsType::Escape:
-            if (m_escapes[lhs.code].length() != 0)
+            if (m_escapes[lhs.code].length != 0)
                 reader.RaiseError("redefining escape");
             m_escapes[lhs.code] = sequence;
             break;
         case LhsType::Constant:
-            if (m_constants.find(lhs.name) != m_constants.end())
+            if (constants.find(lhs.name) != constants.end())
                 reader.RaiseError("redefining constant");
-            m_constants[lhs.name] = sequence;
+            constants[lhs.name] = sequence;
             break;
         }
 
         reader.ExpectEmptyRestOfLine();
     }
+
+    BuildConstantTable(constants);
+}
+
+void Charmap::AddChar(std::int32_t code, const CharmapSequence& sequence)
+{
+    if (code >= 0 && code < kNumBmpCodes)
+    {
+        if (m_charSequences.size() > UINT16_MAX)
+            FATAL_ERROR("too many chars in charmap\n");
+
+        m_charIndices[code] = static_cast<std::uint16_t>(m_charSequences.size());
+        m_charSequences.push_back(sequence);
+    }
+    else
+    {
+        m_supplementaryChars[code] = sequence;
+    }
+}
+
+// Builds a hash-and-displace perfect hash. Constants are first split into
+// buckets, then the largest buckets are placed first, trying displacements
+// until every constant in the bucket lands in a free slot.
+void Charmap::BuildConstantTable(const std::map<std::string, CharmapSequence>& constants)
+{
+    std::size_t numBuckets = RoundUpToPowerOfTwo(constants.size() / 4 + 1);
+    std::size_t numSlots = RoundUpToPowerOfTwo(constants.size() * 2 + 1);
+    std::vector<std::vector<const std::string*>> buckets(numBuckets);
+
+    for (const auto& pair : constants)
+    {
+        const std::string& name = pair.first;
+        buckets[HashConstantName(name.data(), name.length(), 0) & (numBuckets - 1)].push_back(&name);
+    }
+
+    std::vector<std::size_t> order(numBuckets);
+
+    for (std::size_t i = 0; i < numBuckets; i++)
+        order[i] = i;
+
+    std::stable_sort(order.begin(), order.end(), [&buckets](std::size_t a, std::size_t b) {
+        return buckets[a].size() > buckets[b].size();
+    });
+
+    m_constantDisplacements.assign(numBuckets, 0);
+    m_constantSlots.assign(numSlots, ConstantSlot());
+
+    std::vector<bool> used(numSlots, false);
+    std::vector<std::size_t> slots;
+
+    for (std::size_t bucketIndex : order)
+    {
+        const std::vector<const std::string*>& bucket = buckets[bucketIndex];
+
+        if (bucket.empty())
+            break;
+
+        std::uint32_t displacement;
+
+        for (displacement = 1; displacement != 0; displacement++)
+        {
+            slots.clear();
+
+            for (const std::string* name : bucket)
+            {
+                std::size_t slot = HashConstantName(name->data(), name->length(), displacement) & (numSlots - 1);
+
+                if (used[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end())
+                    break;
+
+                slots.push_back(slot);
+            }
+
+            if (slots.size() == bucket.size())
+                break;
+        }
+
+        if (displacement == 0)
+            FATAL_ERROR("failed to build charmap constant table\n");
+
+        m_constantDisplacements[bucketIndex] = displacement;
+
+        for (std::size_t i = 0; i < bucket.size(); i++)
+        {
+            used[slots[i]] = true;
+            m_constantSlots[slots[i]].name = *bucket[i];
+            m_constantSlots[slots[i]].sequence = constants.at(*bucket[i]);
+        }
+    }
+}
+
+const CharmapSequence* Charmap::Constant(const char* name, std::size_t length) const
+{
+    std::size_t numBuckets = m_constantDisplacements.size();
+    std::size_t numSlots = m_constantSlots.size();
+    std::uint32_t displacement = m_constantDisplacements[HashConstantName(name, length, 0) & (numBuckets - 1)];
+
+    // Displacement 0 marks an empty bucket.
+    if (displacement == 0)
+        return nullptr;
+
+    const ConstantSlot& slot = m_constantSlots[HashConstantName(name, length, displacement) & (numSlots - 1)];
+
+    if (slot.name.length() != length || std::memcmp(slot.name.data(), name, length) != 0)
+        return nullptr;
+
+    return &slot.sequence;
 }
@@ -21,44 +21,78 @@
 #ifndef CHARMAP_H
 #define CHARMAP_H
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <map>
 #include <vector>
 
+const unsigned long kMaxCharmapSequenceLength = 16;
+
+// A mapped byte sequence. The bytes are stored inline so that looking one up
+// never allocates.
+struct CharmapSequence
+{
+    unsigned char length;
+    unsigned char bytes[kMaxCharmapSequenceLength];
+};
+
+// The lookups return nullptr when there's no mapping.
 class Charmap
 {
 public:
     Charmap(std::string filename);
 
-    std::string Char(std::int32_t code)
+    const CharmapSequence* Char(std::int32_t code) const
     {
-        auto it = m_chars.find(code);
+        if (code >= 0 && code < kNumBmpCodes)
+        {
+            std::uint16_t index = m_charIndices[code];
+            return index != 0 ? &m_charSequences[index] : nullptr;
+        }
+
+        auto it = m_supplementaryChars.find(code);
 
-        if (it == m_chars.end())
-            return std::string();
+        if (it == m_supplementaryChars.end())
+            return nullptr;
 
-        return it->second;
+        return &it->second;
     }
 
-    std::string Escape(unsigned char code)
+    const CharmapSequence* Escape(unsigned char code) const
     {
-        return m_escapes[code];
+        if (code >= 128 || m_escapes[code].length == 0)
+            return nullptr;
+
+        return &m_escapes[code];
     }
 
-    std::string Constant(std::string identifier)
+    const CharmapSequence* Constant(const char* name, std::size_t length) const;
+
+private:
+    static const std::int32_t kNumBmpCodes = 0x10000;
+
+    struct ConstantSlot
     {
-        auto it = m_constants.find(identifier);
+        std::string name;
+        CharmapSequence sequence;
+    };
 
-        if (it == m_constants.end())
-            return std::string();
+    // Chars in the Basic Multilingual Plane are looked up directly through
+    // m_charIndices; index 0 means unmapped. Anything above that is rare
+    // enough to go in a map.
+    std::vector<std::uint16_t> m_charIndices;
+    std::vector<CharmapSequence> m_charSequences;
+    std::map<std::int32_t, CharmapSequence> m_supplementaryChars;
+    CharmapSequence m_escapes[128];
 
-        return it->second;
-    }
-private:
-    std::map<std::int32_t, std::string> m_chars;
-    std::string m_escapes[128];
-    std::map<std::string, std::string> m_constants;
+    // Constants are stored in a perfect hash table: each bucket has a
+    // displacement chosen so that no two constants share a slot.
+    std::vector<std::uint32_t> m_constantDisplacements;
+    std::vector<ConstantSlot> m_constantSlots;
+
+    void AddChar(std::int32_t code, const CharmapSequence& sequence);
+    void BuildConstantTable(const std::map<std::string, CharmapSequence>& constants);
 };
 
 #endif // CHARMAP_H
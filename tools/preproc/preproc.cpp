@@ -18,6 +18,9 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
+#include <chrono>
+#include <cstdarg>
+#include <cstring>
 #include <string>
 #include <stack>
 #include "preproc.h"
@@ -26,20 +29,133 @@
 #include "charmap.h"
 
 Charmap* g_charmap;
+OutputBuffer g_output;
+
+// "0x00" through "0xFF", so strings don't need a printf per byte.
+static struct HexByteTable
+{
+    char entries[256][4];
+
+    HexByteTable()
+    {
+        static const char digits[] = "0123456789ABCDEF";
+
+        for (int i = 0; i < 256; i++)
+        {
+            entries[i][0] = '0';
+            entries[i][1] = 'x';
+            entries[i][2] = digits[i >> 4];
+            entries[i][3] = digits[i & 0xF];
+        }
+    }
+} s_hexByteTable;
+
+void OutputBuffer::Write(const char* data, std::size_t length)
+{
+    if (length > kOutputBufferSize - m_size)
+    {
+        Flush();
+
+        if (length >= kOutputBufferSize)
+        {
+            std::fwrite(data, 1, length, stdout);
+            m_totalBytes += length;
+            return;
+        }
+    }
+
+    std::memcpy(&m_data[m_size], data, length);
+    m_size += length;
+}
+
+void OutputBuffer::PutHexByte(unsigned char byte)
+{
+    Write(s_hexByteTable.entries[byte], 4);
+}
+
+void OutputBuffer::PutSigned(std::int32_t value)
+{
+    if (value < 0)
+    {
+        Put('-');
+        PutUnsigned(0u - static_cast<std::uint32_t>(value));
+    }
+    else
+    {
+        PutUnsigned(static_cast<std::uint32_t>(value));
+    }
+}
+
+void OutputBuffer::PutUnsigned(std::uint32_t value)
+{
+    char digits[10];
+    int length = 0;
+
+    do
+    {
+        digits[sizeof(digits) - 1 - length++] = '0' + value % 10;
+        value /= 10;
+    } while (value != 0);
+
+    Write(&digits[sizeof(digits) - length], length);
+}
+
+void OutputBuffer::Print(const char* format, ...)
+{
+    char buffer[1024];
+    std::va_list args;
+
+    va_start(args, format);
+    int length = std::vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    if (length < 0)
+        FATAL_ERROR("Failed to format output.\n");
+
+    if (static_cast<std::size_t>(length) < sizeof(buffer))
+    {
+        Write(buffer, length);
+        return;
+    }
+
+    std::string large(length + 1, '\0');
+
+    va_start(args, format);
+    std::vsnprintf(&large[0], large.size(), format, args);
+    va_end(args);
+
+    Write(large.data(), length);
+}
+
+void OutputBuffer::Flush()
+{
+    if (!TryFlush())
+        FATAL_ERROR("Failed to write output.\n");
+}
+
+// Like Flush, but leaves reporting a failed write to the caller.
+bool OutputBuffer::TryFlush()
+{
+    bool written = m_size == 0 || std::fwrite(m_data, 1, m_size, stdout) == m_size;
+
+    m_totalBytes += m_size;
+    m_size = 0;
+    return written;
+}
 
 void PrintAsmBytes(unsigned char *s, int length)
 {
     if (length > 0)
     {
-        std::printf("\t.byte ");
+        g_output.Write("\t.byte ", 7);
         for (int i = 0; i < length; i++)
         {
-            std::printf("0x%02X", s[i]);
+            g_output.PutHexByte(s[i]);
 
             if (i < length - 1)
-                std::printf(", ");
+                g_output.Write(", ", 2);
         }
-        std::putchar('\n');
+        g_output.Put('\n');
     }
 }
 
@@ -90,7 +206,7 @@ void PreprocAsmFile(std::string filename)
             if (globalLabel.length() != 0)
             {
                 const char *s = globalLabel.c_str();
-                std::printf("%s: ; .global %s\n", s, s);
+                g_output.Print("%s: ; .global %s\n", s, s);
             }
             else
             {
@@ -130,35 +246,136 @@ char* GetFileExtension(char* filename)
     return extension;
 }
 
+void PreprocFile(char* filename, bool isStdin)
+{
+    char* extension = GetFileExtension(filename);
+
+    if (!extension)
+        FATAL_ERROR("\"%s\" has no file extension.\n", filename);
+
+    if ((extension[0] == 's') && extension[1] == 0)
+        PreprocAsmFile(filename);
+    else if ((extension[0] == 'c' || extension[0] == 'i') && extension[1] == 0)
+        PreprocCFile(filename, isStdin);
+    else
+        FATAL_ERROR("\"%s\" has an unknown file extension of \"%s\".\n", filename, extension);
+
+    g_output.Flush();
+}
+
+// Processes every job in a job file with the same charmap, so it only has to be
+// read once. Each line has the form "SRC_FILE OUTPUT_FILE". Jobs are run in
+// order, so either path may be a named pipe as long as the other end is opened
+// in the same order.
+void PreprocJobFile(const char* jobFilename)
+{
+    FILE* fp = std::fopen(jobFilename, "rb");
+
+    if (fp == NULL)
+        FATAL_ERROR("Failed to open \"%s\" for reading.\n", jobFilename);
+
+    char line[2 * kMaxPath + 2];
+    int lineNum = 0;
+
+    while (std::fgets(line, sizeof(line), fp) != NULL)
+    {
+        char srcFilename[kMaxPath + 1];
+        char outputFilename[kMaxPath + 1];
+        char junk;
+
+        lineNum++;
+
+        int count = std::sscanf(line, "%256s %256s %c", srcFilename, outputFilename, &junk);
+
+        if (count <= 0)
+            continue;
+
+        if (count != 2)
+            FATAL_ERROR("%s:%d: error: expected \"SRC_FILE OUTPUT_FILE\"\n", jobFilename, lineNum);
+
+        if (std::freopen(outputFilename, "wb", stdout) == NULL)
+            FATAL_ERROR("Failed to open \"%s\" for writing.\n", outputFilename);
+
+        PreprocFile(srcFilename, false);
+
+        std::fflush(stdout);
+    }
+
+    std::fclose(fp);
+}
+
+// Errors exit directly, so make sure whatever was produced before them still
+// gets written, as it would have been with unbuffered output. This runs during
+// exit, where calling exit again is undefined, so a failed write is only reported.
+static void FlushOutputAtExit()
+{
+    if (!g_output.TryFlush())
+        std::fprintf(stderr, "Failed to write output.\n");
+}
+
+void PrintBenchmark(std::chrono::steady_clock::time_point start)
+{
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    unsigned long long bytes = g_output.TotalBytes();
+
+    std::fprintf(stderr, "preproc: wrote %llu bytes in %.3f ms (%.2f MB/s)\n",
+        bytes, seconds * 1000.0, seconds > 0.0 ? bytes / seconds / 1e6 : 0.0);
+}
+
 int main(int argc, char **argv)
 {
+    auto start = std::chrono::steady_clock::now();
+    bool bench = false;
+
+    std::atexit(FlushOutputAtExit);
+    int numArgs = 0;
+
+    // --bench may appear anywhere; strip it so the positional arguments are unchanged.
+    for (int i = 0; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--bench") == 0)
+            bench = true;
+        else
+            argv[numArgs++] = argv[i];
+    }
+
+    argc = numArgs;
+
+    if (argc == 4 && std::strcmp(argv[1], "-j") == 0)
+    {
+        g_charmap = new Charmap(argv[3]);
+        PreprocJobFile(argv[2]);
+        if (bench)
+            PrintBenchmark(start);
+        return 0;
+    }
+
     if (argc < 3 || argc > 4)
     {
-        std::fprintf(stderr, "Usage: %s SRC_FILE CHARMAP_FILE [-i]\nwhere -i denotes if input is from stdin\n", argv[0]);
+        std::fprintf(stderr, "Usage: %s SRC_FILE CHARMAP_FILE [-i] [--bench]\n"
+                             "       %s -j JOB_FILE CHARMAP_FILE [--bench]\n"
+                             "where -i denotes if input is from stdin,\n"
+                             "each line of JOB_FILE is \"SRC_FILE OUTPUT_FILE\"\n"
+                             "and --bench reports the output throughput on stderr\n", argv[0], argv[0]);
         return 1;
     }
 
     g_charmap = new Charmap(argv[2]);
 
-    char* extension = GetFileExtension(argv[1]);
+    bool isStdin = false;
 
-    if (!extension)
-        FATAL_ERROR("\"%s\" has no file extension.\n", argv[1]);
+    if (argc == 4)
+    {
+        if (argv[3][0] == '-' && argv[3][1] == 'i' && argv[3][2] == '\0')
+            isStdin = true;
+        else
+            FATAL_ERROR("unknown argument flag \"%s\".\n", argv[3]);
+    }
 
-    if ((extension[0] == 's') && extension[1] == 0)
-        PreprocAsmFile(argv[1]);
-    else if ((extension[0] == 'c' || extension[0] == 'i') && extension[1] == 0) {
-        if (argc == 4) {
-            if (argv[3][0] == '-' && argv[3][1] == 'i' && argv[3][2] == '\0') {
-                PreprocCFile(argv[1], true);
-            } else {
-                FATAL_ERROR("unknown argument flag \"%s\".\n", argv[3]);
-            }
-        } else {
-            PreprocCFile(argv[1], false);
-        }
-    } else
-        FATAL_ERROR("\"%s\" has an unknown file extension of \"%s\".\n", argv[1], extension);
+    PreprocFile(argv[1], isStdin);
+
+    if (bench)
+        PrintBenchmark(start);
 
     return 0;
 }
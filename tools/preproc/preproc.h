@@ -21,6 +21,8 @@
 #ifndef PREPROC_H
 #define PREPROC_H
 
+#include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include "charmap.h"
@@ -47,8 +49,44 @@ do                                               \
 
 const int kMaxPath = 256;
 const int kMaxStringLength = 1024;
-const unsigned long kMaxCharmapSequenceLength = 16;
+
+const std::size_t kOutputBufferSize = 1 << 16;
+
+// All preprocessed output goes through this buffer, which is written to
+// stdout in large blocks rather than one character or printf at a time.
+class OutputBuffer
+{
+public:
+    OutputBuffer() : m_size(0), m_totalBytes(0) {}
+
+    void Put(char c)
+    {
+        if (m_size == kOutputBufferSize)
+            Flush();
+
+        m_data[m_size++] = c;
+    }
+
+    void Write(const char* data, std::size_t length);
+    void PutHexByte(unsigned char byte);
+    void PutSigned(std::int32_t value);
+    void PutUnsigned(std::uint32_t value);
+    void Print(const char* format, ...);
+    void Flush();
+    bool TryFlush();
+
+    std::uint64_t TotalBytes() const
+    {
+        return m_totalBytes + m_size;
+    }
+
+private:
+    char m_data[kOutputBufferSize];
+    std::size_t m_size;
+    std::uint64_t m_totalBytes;
+};
 
 extern Charmap* g_charmap;
+extern OutputBuffer g_output;
 
 #endif // PREPROC_H
@@ -26,10 +26,24 @@
 #include "char_util.h"
 #include "utf8.h"
 
+void StringParser::AppendByte(unsigned char byte)
+{
+    if (m_destLength == kMaxStringLength)
+        RaiseError("mapped string longer than %d bytes", kMaxStringLength);
+
+    m_dest[m_destLength++] = byte;
+}
+
+void StringParser::AppendSequence(const CharmapSequence& sequence)
+{
+    for (int i = 0; i < sequence.length; i++)
+        AppendByte(sequence.bytes[i]);
+}
+
 // Reads a charmap char or escape sequence.
-std::string StringParser::ReadCharOrEscape()
+void StringParser::ReadCharOrEscape()
 {
-    std::string sequence;
+    const CharmapSequence* sequence;
 
     bool isEscape = (m_buffer[m_pos] == '\\');
 
@@ -41,19 +55,21 @@ std::string StringParser::ReadCharOrEscape()
         {
             sequence = g_charmap->Char('"');
 
-            if (sequence.length() == 0)
+            if (sequence == nullptr)
                 RaiseError("no mapping exists for double quote");
 
-            return sequence;
+            AppendSequence(*sequence);
+            return;
         }
         else if (m_buffer[m_pos] == '\\')
         {
             sequence = g_charmap->Char('\\');
 
-            if (sequence.length() == 0)
+            if (sequence == nullptr)
                 RaiseError("no mapping exists for backslash");
 
-            return sequence;
+            AppendSequence(*sequence);
+            return;
         }
     }
 
@@ -82,7 +98,7 @@ std::string StringParser::ReadCharOrEscape()
 
     sequence = isEscape ? g_charmap->Escape(code) : g_charmap->Char(code);
 
-    if (sequence.length() == 0)
+    if (sequence == nullptr)
     {
         if (isEscape)
             RaiseError("unknown escape '\\%c'", code);
@@ -90,14 +106,12 @@ std::string StringParser::ReadCharOrEscape()
             RaiseError("unknown character U+%X", code);
     }
 
-    return sequence;
+    AppendSequence(*sequence);
 }
 
 // Reads a charmap constant, i.e. "{FOO}".
-std::string StringParser::ReadBracketedConstants()
+void StringParser::ReadBracketedConstants()
 {
-    std::string totalSequence;
-
     m_pos++; // Assume we're on the left curly bracket.
 
     while (m_buffer[m_pos] != '}')
@@ -113,15 +127,15 @@ std::string StringParser::ReadBracketedConstants()
             while (IsIdentifierChar(m_buffer[m_pos]))
                 m_pos++;
 
-            std::string sequence = g_charmap->Constant(std::string(&m_buffer[startPos], m_pos - startPos));
+            const CharmapSequence* sequence = g_charmap->Constant(&m_buffer[startPos], m_pos - startPos);
 
-            if (sequence.length() == 0)
+            if (sequence == nullptr)
             {
                 m_buffer[m_pos] = 0;
                 RaiseError("unknown constant '%s'", &m_buffer[startPos]);
             }
 
-            totalSequence += sequence;
+            AppendSequence(*sequence);
         }
         else if (IsAsciiDigit(m_buffer[m_pos]))
         {
@@ -130,17 +144,17 @@ std::string StringParser::ReadBracketedConstants()
             switch (integer.size)
             {
             case 1:
-                totalSequence += (unsigned char)integer.value;
+                AppendByte(integer.value);
                 break;
             case 2:
-                totalSequence += (unsigned char)integer.value;
-                totalSequence += (unsigned char)(integer.value >> 8);
+                AppendByte(integer.value);
+                AppendByte(integer.value >> 8);
                 break;
             case 4:
-                totalSequence += (unsigned char)integer.value;
-                totalSequence += (unsigned char)(integer.value >> 8);
-                totalSequence += (unsigned char)(integer.value >> 16);
-                totalSequence += (unsigned char)(integer.value >> 24);
+                AppendByte(integer.value);
+                AppendByte(integer.value >> 8);
+                AppendByte(integer.value >> 16);
+                AppendByte(integer.value >> 24);
                 break;
             }
         }
@@ -161,8 +175,6 @@ std::string StringParser::ReadBracketedConstants()
     }
 
     m_pos++; // Go past the right curly bracket.
-
-    return totalSequence;
 }
 
 // Reads a charmap string.
@@ -177,23 +189,21 @@ int StringParser::ParseString(long srcPos, unsigned char* dest, int& destLength)
 
     m_pos++;
 
-    destLength = 0;
+    m_dest = dest;
+    m_destLength = 0;
 
     while (m_buffer[m_pos] != '"')
     {
-        std::string sequence = (m_buffer[m_pos] == '{') ? ReadBracketedConstants() : ReadCharOrEscape();
-
-        for (const char& c : sequence)
-        {
-            if (destLength == kMaxStringLength)
-                RaiseError("mapped string longer than %d bytes", kMaxStringLength);
-
-            dest[destLength++] = c;
-        }
+        if (m_buffer[m_pos] == '{')
+            ReadBracketedConstants();
+        else
+            ReadCharOrEscape();
     }
 
     m_pos++; // Go past the right quote.
 
+    destLength = m_destLength;
+
     return m_pos - start;
 }
 
@@ -28,7 +28,7 @@
 class StringParser
 {
 public:
-    StringParser(char* buffer, long size) : m_buffer(buffer), m_size(size), m_pos(0) {}
+    StringParser(char* buffer, long size) : m_buffer(buffer), m_size(size), m_pos(0), m_dest(nullptr), m_destLength(0) {}
     int ParseString(long srcPos, unsigned char* dest, int &destLength);
 
 private:
@@ -41,12 +41,16 @@ private:
     char* m_buffer;
     long m_size;
     long m_pos;
+    unsigned char* m_dest;
+    int m_destLength;
 
     Integer ReadInteger();
     Integer ReadDecimal();
     Integer ReadHex();
-    std::string ReadCharOrEscape();
-    std::string ReadBracketedConstants();
+    void AppendByte(unsigned char byte);
+    void AppendSequence(const CharmapSequence& sequence);
+    void ReadCharOrEscape();
+    void ReadBracketedConstants();
     void SkipWhitespace();
     void SkipRestOfInteger(int radix);
     void RaiseError(const char* format, ...);
@@ -21,9 +21,11 @@
 #include <cstdio>
 #include <cstdlib>
 #include <list>
+#include <map>
 #include <queue>
 #include <set>
 #include <string>
+#include <vector>
 #include "scaninc.h"
 #include "source_file.h"
 
@@ -38,19 +40,167 @@ bool CanOpenFile(std::string path)
     return true;
 }
 
-const char *const USAGE = "Usage: scaninc [-I INCLUDE_PATH] FILE_PATH\n";
+const char *const USAGE =
+    "Usage: scaninc [-I INCLUDE_PATH] FILE_PATH\n"
+    "       scaninc [-I INCLUDE_PATH] -M DEPFILE [-O OBJ_DIR] [-C CACHE_FILE] FILE_PATH...\n";
 
-int main(int argc, char **argv)
+// An include as it was found in a file, after searching the include paths.
+struct ResolvedInclude
+{
+    std::string path;
+    bool exists;
+};
+
+class DependencyScanner
+{
+public:
+    DependencyScanner(const std::vector<std::string>& includeDirs, SourceFileCache& cache)
+        : m_includeDirs(includeDirs), m_cache(cache) {}
+
+    std::set<std::string> Scan(const std::string& initialPath);
+
+private:
+    std::vector<std::string> m_includeDirs;
+    SourceFileCache& m_cache;
+    std::map<std::string, bool> m_canOpen;
+    std::map<std::string, std::vector<ResolvedInclude>> m_resolved;
+
+    bool Exists(const std::string& path);
+    const std::vector<ResolvedInclude>& Resolve(const std::string& filePath, const ScannedFile& file);
+};
+
+bool DependencyScanner::Exists(const std::string& path)
+{
+    auto it = m_canOpen.find(path);
+
+    if (it != m_canOpen.end())
+        return it->second;
+
+    bool exists = CanOpenFile(path);
+    m_canOpen[path] = exists;
+    return exists;
+}
+
+// Where an include ends up only depends on the including file's directory and
+// the include paths, so the result can be shared by every file that reaches it.
+const std::vector<ResolvedInclude>& DependencyScanner::Resolve(const std::string& filePath, const ScannedFile& file)
+{
+    auto it = m_resolved.find(filePath);
+
+    if (it != m_resolved.end())
+        return it->second;
+
+    std::vector<ResolvedInclude>& resolved = m_resolved[filePath];
+
+    m_includeDirs.push_back(file.srcDir);
+    for (auto include : file.includes)
+    {
+        bool exists = false;
+        std::string path("");
+        for (auto includeDir : m_includeDirs)
+        {
+            path = includeDir + include;
+            if (Exists(path))
+            {
+                exists = true;
+                break;
+            }
+        }
+        if (!exists && (file.type == SourceFileType::Asm || file.type == SourceFileType::Inc))
+        {
+            path = include;
+        }
+        resolved.push_back(ResolvedInclude{path, exists});
+    }
+    m_includeDirs.pop_back();
+
+    return resolved;
+}
+
+std::set<std::string> DependencyScanner::Scan(const std::string& initialPath)
 {
     std::queue<std::string> filesToProcess;
     std::set<std::string> dependencies;
 
+    filesToProcess.push(initialPath);
+
+    while (!filesToProcess.empty())
+    {
+        std::string filePath = filesToProcess.front();
+        const ScannedFile& file = m_cache.Get(filePath);
+        filesToProcess.pop();
+
+        for (auto incbin : file.incbins)
+        {
+            dependencies.insert(incbin);
+        }
+        for (const ResolvedInclude& include : Resolve(filePath, file))
+        {
+            bool inserted = dependencies.insert(include.path).second;
+            if (inserted && include.exists)
+            {
+                filesToProcess.push(include.path);
+            }
+        }
+    }
+
+    return dependencies;
+}
+
+// Object paths mirror the source tree: src/foo.c -> OBJ_DIR/src/foo.o
+std::string GetObjectPath(const std::string& objDir, const std::string& sourcePath)
+{
+    std::size_t dot = sourcePath.find_last_of('.');
+    std::size_t slash = sourcePath.find_last_of('/');
+    std::string stem = sourcePath;
+
+    if (dot != std::string::npos && (slash == std::string::npos || dot > slash))
+        stem = sourcePath.substr(0, dot);
+
+    if (objDir.empty())
+        return stem + ".o";
+
+    return objDir + "/" + stem + ".o";
+}
+
+void WriteDepfile(const std::string& depfilePath, const std::string& objDir, const std::vector<std::string>& sources, DependencyScanner& scanner)
+{
+    // Don't leave a depfile from a previous run behind if scanning fails.
+    std::remove(depfilePath.c_str());
+
+    std::string output;
+
+    for (const std::string& source : sources)
+    {
+        output += GetObjectPath(objDir, source) + ":";
+        for (const std::string& path : scanner.Scan(source))
+        {
+            output += " \\\n\t" + path;
+        }
+        output += "\n";
+    }
+
+    FILE *fp = std::fopen(depfilePath.c_str(), "wb");
+
+    if (fp == NULL)
+        FATAL_ERROR("Failed to open \"%s\" for writing.\n", depfilePath.c_str());
+
+    std::fwrite(output.data(), 1, output.size(), fp);
+    std::fclose(fp);
+}
+
+int main(int argc, char **argv)
+{
     std::vector<std::string> includeDirs;
+    std::vector<std::string> sources;
+    std::string depfilePath;
+    std::string objDir;
+    std::string cachePath;
 
     argc--;
     argv++;
 
-    while (argc > 1)
+    while (argc > 0)
     {
         std::string arg(argv[0]);
         if (arg.substr(0, 2) == "-I")
@@ -58,6 +208,8 @@ int main(int argc, char **argv)
             std::string includeDir = arg.substr(2);
             if (includeDir.empty())
             {
+                if (argc < 2)
+                    FATAL_ERROR(USAGE);
                 argc--;
                 argv++;
                 includeDir = std::string(argv[0]);
@@ -68,61 +220,54 @@ int main(int argc, char **argv)
             }
             includeDirs.push_back(includeDir);
         }
-        else
+        else if (arg == "-M" || arg == "-O" || arg == "-C")
+        {
+            if (argc < 2)
+                FATAL_ERROR(USAGE);
+            argc--;
+            argv++;
+            if (arg == "-M")
+                depfilePath = argv[0];
+            else if (arg == "-O")
+                objDir = argv[0];
+            else
+                cachePath = argv[0];
+        }
+        else if (arg.substr(0, 1) == "-")
         {
             FATAL_ERROR(USAGE);
         }
+        else
+        {
+            sources.push_back(arg);
+        }
         argc--;
         argv++;
     }
 
-    if (argc != 1) {
+    if (sources.empty() || (depfilePath.empty() && (sources.size() != 1 || !objDir.empty() || !cachePath.empty())))
+    {
         FATAL_ERROR(USAGE);
     }
 
-    std::string initialPath(argv[0]);
+    SourceFileCache cache;
 
-    filesToProcess.push(initialPath);
+    if (!cachePath.empty())
+        cache.Load(cachePath);
 
-    while (!filesToProcess.empty())
-    {
-        std::string filePath = filesToProcess.front();
-        SourceFile file(filePath);
-        filesToProcess.pop();
+    DependencyScanner scanner(includeDirs, cache);
 
-        includeDirs.push_back(file.GetSrcDir());
-        for (auto incbin : file.GetIncbins())
-        {
-            dependencies.insert(incbin);
-        }
-        for (auto include : file.GetIncludes())
+    if (depfilePath.empty())
+    {
+        for (const std::string &path : scanner.Scan(sources[0]))
         {
-            bool exists = false;
-            std::string path("");
-            for (auto includeDir : includeDirs)
-            {
-                path = includeDir + include;
-                if (CanOpenFile(path))
-                {
-                    exists = true;
-                    break;
-                }
-            }
-            if (!exists && (file.FileType() == SourceFileType::Asm || file.FileType() == SourceFileType::Inc))
-            {
-                path = include;
-            }
-            bool inserted = dependencies.insert(path).second;
-            if (inserted && exists)
-            {
-                filesToProcess.push(path);
-            }
+            std::printf("%s\n", path.c_str());
         }
-        includeDirs.pop_back();
+        return 0;
     }
 
-    for (const std::string &path : dependencies)
-    {
-        std::printf("%s\n", path.c_str());
-    }
+    WriteDepfile(depfilePath, objDir, sources, scanner);
+
+    if (!cachePath.empty())
+        cache.Save(cachePath);
 }
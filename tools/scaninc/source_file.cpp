@@ -19,8 +19,12 @@
 // THE SOFTWARE.
 
 #include <new>
+#include <fstream>
+#include <sys/stat.h>
 #include "source_file.h"
 
+static const char *const CACHE_HEADER = "scaninc cache v2";
+
 
 SourceFileType GetFileType(std::string& path)
 {
@@ -128,3 +132,157 @@ std::string& SourceFile::GetSrcDir()
     return m_src_dir;
 }
 
+
+// The modification time is kept to the nanosecond where the platform has it,
+// so an edit that keeps the size is still seen when it lands in the same
+// second as the previous scan.
+static bool StatFile(const std::string& path, long long& mtime, long long& mtimeNsec, long long& size)
+{
+    struct stat st;
+
+    if (stat(path.c_str(), &st) != 0)
+        return false;
+
+    mtime = st.st_mtime;
+#if defined(__APPLE__)
+    mtimeNsec = st.st_mtimespec.tv_nsec;
+#elif defined(_WIN32)
+    mtimeNsec = 0;
+#else
+    mtimeNsec = st.st_mtim.tv_nsec;
+#endif
+    size = st.st_size;
+    return true;
+}
+
+// The cache file is line based:
+//   F <mtime> <mtime nanoseconds> <size> <type> <path>
+//   I <include path>
+//   B <incbin path>
+// where the I and B lines belong to the preceding F line.
+void SourceFileCache::Load(const std::string& cachePath)
+{
+    std::ifstream in(cachePath);
+
+    if (!in.is_open())
+        return;
+
+    std::string line;
+
+    if (!std::getline(in, line) || line != CACHE_HEADER)
+        return;
+
+    Entry *entry = nullptr;
+
+    while (std::getline(in, line))
+    {
+        if (line.size() < 2 || line[1] != ' ')
+        {
+            // Corrupt cache; throw everything away and rescan.
+            m_entries.clear();
+            return;
+        }
+
+        std::string value = line.substr(2);
+
+        if (line[0] == 'F')
+        {
+            long long mtime, mtimeNsec, size;
+            int type, consumed;
+
+            if (std::sscanf(value.c_str(), "%lld %lld %lld %d %n", &mtime, &mtimeNsec, &size, &type, &consumed) != 4)
+            {
+                m_entries.clear();
+                return;
+            }
+
+            std::string path = value.substr(consumed);
+            entry = &m_entries[path];
+            entry->mtime = mtime;
+            entry->mtimeNsec = mtimeNsec;
+            entry->size = size;
+            entry->checked = false;
+            entry->file.type = static_cast<SourceFileType>(type);
+            entry->file.srcDir = GetDir(path);
+        }
+        else if (entry != nullptr && line[0] == 'I')
+        {
+            entry->file.includes.insert(value);
+        }
+        else if (entry != nullptr && line[0] == 'B')
+        {
+            entry->file.incbins.insert(value);
+        }
+        else
+        {
+            m_entries.clear();
+            return;
+        }
+    }
+}
+
+// Only files that were looked at during this run are written back, so files
+// that have been deleted or are no longer part of the build drop out.
+void SourceFileCache::Save(const std::string& cachePath)
+{
+    std::string tempPath = cachePath + ".tmp";
+    FILE *fp = std::fopen(tempPath.c_str(), "wb");
+
+    if (fp == NULL)
+        FATAL_ERROR("Failed to open \"%s\" for writing.\n", tempPath.c_str());
+
+    std::fprintf(fp, "%s\n", CACHE_HEADER);
+
+    for (const auto& pair : m_entries)
+    {
+        const Entry& entry = pair.second;
+
+        if (!entry.checked)
+            continue;
+
+        std::fprintf(fp, "F %lld %lld %lld %d %s\n", entry.mtime, entry.mtimeNsec, entry.size, static_cast<int>(entry.file.type), pair.first.c_str());
+        for (const std::string& include : entry.file.includes)
+            std::fprintf(fp, "I %s\n", include.c_str());
+        for (const std::string& incbin : entry.file.incbins)
+            std::fprintf(fp, "B %s\n", incbin.c_str());
+    }
+
+    std::fclose(fp);
+
+    std::remove(cachePath.c_str());
+    if (std::rename(tempPath.c_str(), cachePath.c_str()) != 0)
+        FATAL_ERROR("Failed to rename \"%s\" to \"%s\".\n", tempPath.c_str(), cachePath.c_str());
+}
+
+const ScannedFile& SourceFileCache::Get(const std::string& path)
+{
+    auto it = m_entries.find(path);
+
+    if (it != m_entries.end() && it->second.checked)
+        return it->second.file;
+
+    long long mtime = -1, mtimeNsec = -1, size = -1;
+    bool exists = StatFile(path, mtime, mtimeNsec, size);
+
+    if (exists && it != m_entries.end() && it->second.mtime == mtime && it->second.mtimeNsec == mtimeNsec
+     && it->second.size == size)
+    {
+        it->second.checked = true;
+        return it->second.file;
+    }
+
+    // Either not cached or stale. SourceFile reports the error if the file can't be read.
+    SourceFile source(path);
+    Entry& entry = m_entries[path];
+
+    entry.mtime = mtime;
+    entry.mtimeNsec = mtimeNsec;
+    entry.size = size;
+    entry.checked = true;
+    entry.file.type = source.FileType();
+    entry.file.srcDir = source.GetSrcDir();
+    entry.file.incbins = source.GetIncbins();
+    entry.file.includes = source.GetIncludes();
+
+    return entry.file;
+}
@@ -21,6 +21,7 @@
 #ifndef SOURCE_FILE_H
 #define SOURCE_FILE_H
 
+#include <map>
 #include <string>
 #include "scaninc.h"
 #include "asm_file.h"
@@ -68,5 +69,38 @@ private:
     std::string m_src_dir;
 };
 
+// The parts of a scanned source file that dependency resolution needs.
+// Unlike SourceFile, this is a plain value so it can be cached.
+struct ScannedFile
+{
+    SourceFileType type;
+    std::string srcDir;
+    std::set<std::string> incbins;
+    std::set<std::string> includes;
+};
+
+// Scans each source file at most once per run. When loaded from a cache file,
+// results from a previous run are reused for files whose modification time
+// and size have not changed, so unchanged headers are never re-read.
+class SourceFileCache
+{
+public:
+    void Load(const std::string& cachePath);
+    void Save(const std::string& cachePath);
+    const ScannedFile& Get(const std::string& path);
+
+private:
+    struct Entry
+    {
+        long long mtime;
+        long long mtimeNsec;
+        long long size;
+        bool checked;
+        ScannedFile file;
+    };
+
+    std::map<std::string, Entry> m_entries;
+};
+
 #endif // SOURCE_FILE_H
 